@@ -0,0 +1,115 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "avltree.h"
+#include "avlsetops.h"
+
+/*
+ * Compare des recherches une a une (AVLtree_search3) et par lots (AVLtree_searchBatch)
+ * sur un arbre construit dans le desordre, pour plusieurs tailles de lot, puis des
+ * insertions et suppressions une a une et par lots (AVLtree_insertBatch/deleteBatch).
+ * Usage : batch [nombre de cles] [nombre de recherches]
+ */
+
+int     compare3(const void * a, const void * b) {
+    return (*(int*)a > *(int*)b) - (*(int*)a < *(int*)b);
+}
+
+double  nowSeconds(void) {
+    struct timespec ts;
+
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+    size_t      size = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1 << 22;
+    size_t      nbQueries = (argc > 2) ? strtoul(argv[2], NULL, 10) : 1 << 21;
+    size_t      batches[] = { 4, 16, 64 };
+    int         *keys, *queries;
+    const void  **pointers;
+    AVLTree     *results;
+    AVLTree     racine = NULL;
+    size_t      i, j, b, n, found;
+    double      start, single, seconds;
+    int         swap;
+
+    keys = (int *) malloc(sizeof(int) * size);
+    queries = (int *) malloc(sizeof(int) * nbQueries);
+    pointers = (const void **) malloc(sizeof(void *) * nbQueries);
+    results = (AVLTree *) malloc(sizeof(AVLTree) * nbQueries);
+    if (!keys || !queries || !pointers || !results)
+        return EXIT_FAILURE;
+
+    srand(42);
+    for (i = 0; i < size; i++)
+        keys[i] = (int) (2 * i);
+    for (i = size; i > 1; i--) {
+        j = ((size_t) rand() * RAND_MAX + rand()) % i;
+        swap = keys[i - 1];
+        keys[i - 1] = keys[j];
+        keys[j] = swap;
+    }
+    for (i = 0; i < size; i++)
+        racine = AVLtree_insertData3(racine, compare3, &keys[i], sizeof(int));
+    for (i = 0; i < nbQueries; i++) {
+        queries[i] = (int) (((size_t) rand() * RAND_MAX + rand()) % (2 * size));
+        pointers[i] = &queries[i];
+    }
+    printf("%zu cles, %zu recherches\n", size, nbQueries);
+
+    start = nowSeconds();
+    for (found = 0, i = 0; i < nbQueries; i++)
+        found += AVLtree_search3(racine, compare3, &queries[i]) != NULL;
+    single = nowSeconds() - start;
+    printf("une a une       %7.1f ns/recherche          (%zu)\n", single * 1e9 / nbQueries, found);
+
+    for (b = 0; b < sizeof(batches) / sizeof(batches[0]); b++) {
+        start = nowSeconds();
+        for (i = 0; i < nbQueries; i += n) {
+            n = (nbQueries - i < batches[b]) ? nbQueries - i : batches[b];
+            AVLtree_searchBatch(racine, compare3, pointers + i, n, results + i);
+        }
+        seconds = nowSeconds() - start;
+        for (found = 0, i = 0; i < nbQueries; i++)
+            found += results[i] != NULL;
+        printf("lots de %-7zu %7.1f ns/recherche  x%.2f  (%zu)\n", batches[b], seconds * 1e9 / nbQueries,
+               single / seconds, found);
+    }
+
+    //lots de cles absentes (impaires), inseres puis retires
+    for (b = 1000; b <= 100000 && b <= size; b *= 10) {
+        double  batchInsert, batchDelete, oneInsert, oneDelete;
+        AVLOps  ops = { .cmp3 = compare3 };
+
+        for (i = 0; i < b; i++)
+            keys[i] = (int) (2 * (((size_t) rand() * RAND_MAX + rand()) % size) + 1);
+        start = nowSeconds();
+        for (i = 0; i < b; i++)
+            racine = AVLtree_insertData3(racine, compare3, &keys[i], sizeof(int));
+        oneInsert = nowSeconds() - start;
+        start = nowSeconds();
+        for (i = 0; i < b; i++)
+            racine = AVLtree_deleteData3(racine, compare3, &keys[i]);
+        oneDelete = nowSeconds() - start;
+
+        start = nowSeconds();
+        racine = AVLtree_insertBatch(racine, &ops, keys, b, sizeof(int), 1);
+        batchInsert = nowSeconds() - start;
+        start = nowSeconds();
+        racine = AVLtree_deleteBatch(racine, &ops, keys, b, sizeof(int), 1);
+        batchDelete = nowSeconds() - start;
+
+        printf("ecriture %-7zu insertion %7.1f -> %7.1f ns/cle  x%.2f   suppression %7.1f -> %7.1f ns/cle  x%.2f\n",
+               b, oneInsert * 1e9 / b, batchInsert * 1e9 / b, oneInsert / batchInsert,
+               oneDelete * 1e9 / b, batchDelete * 1e9 / b, oneDelete / batchDelete);
+    }
+
+    AVLtree_deleteTree(&racine);
+    free(keys);
+    free(queries);
+    free(pointers);
+    free(results);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,388 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include <sys/resource.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "avltree.h"
+#include "avlcursor.h"
+
+/*
+ * Banc d'essai des arbres AVL : insertion, recherche, suppression et parcours pour
+ * plusieurs tailles d'arbre et tailles de donnee. Les resultats sont ecrits en JSON pour
+ * pouvoir comparer deux versions ; la progression est affichee sur la sortie d'erreur.
+ *
+ * Usage : bench [-n nombre max de cles] [-q operations max par mesure]
+ *               [-p tailles de donnee, ex. 4,32,256] [-o fichier JSON]
+ * Les tailles d'arbre vont de 10^3 a la valeur de -n (10^6 par defaut, 10^8 au plus)
+ * par puissances de 10.
+ *
+ * Charges mesurees sur chaque arbre :
+ *  insert_sequential   insertion des cles 0..n-1 dans l'ordre
+ *  insert_random       insertion des memes cles dans le desordre
+ *  search_random       recherches uniformes de cles presentes
+ *  search_zipfian      recherches de cles presentes selon une loi de Zipf (theta = 0.99)
+ *  traversal           parcours infixe, une operation par noeud visite
+ *  mixed               90% de recherches (Zipf), 5% d'insertions, 5% de suppressions
+ *  delete_random       suppression de toutes les cles dans le desordre
+ *
+ * La latence n'est mesuree que sur une operation sur 'stride' (au plus BENCH_SAMPLES
+ * mesures par charge) pour ne pas fausser le debit.
+ */
+
+#define BENCH_SAMPLES       100000
+#define BENCH_MAX_KEYS      100000000
+#define BENCH_ZIPF_THETA    0.99
+
+typedef struct Bench Bench;
+struct          Bench {
+        AVLTree         tree;
+        AVLCursor       cursor;
+        size_t          size;
+        size_t          elemSize;
+        char            *elem;
+        int             *keys;
+        int             *queries;
+        size_t          hits;
+};
+
+typedef struct Zipf Zipf;
+struct          Zipf {
+        size_t          size;
+        double          theta;
+        double          zetan;
+        double          alpha;
+        double          eta;
+};
+
+typedef void (*BenchOp)(Bench *bench, size_t index);
+
+//----------------------------------------
+int     compare3(const void * a, const void * b) {
+    int x, y;
+
+    memcpy(&x, a, sizeof(int));
+    memcpy(&y, b, sizeof(int));
+    return (x > y) - (x < y);
+}
+
+double  nowNanos(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/*
+ * Generateur pseudo-aleatoire splitmix64 : rapide, deterministe et sur 64 bits, ce que
+ * rand() ne garantit pas pour 10^8 cles.
+ */
+uint64_t nextRandom(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+double  nextUniform(uint64_t *state) {
+    return (nextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+void    shuffle(int *array, size_t count, uint64_t *state) {
+    size_t  i, j;
+    int     swap;
+
+    for (i = count; i > 1; i--) {
+        j = nextRandom(state) % i;
+        swap = array[i - 1];
+        array[i - 1] = array[j];
+        array[j] = swap;
+    }
+}
+
+/*
+ * Loi de Zipf sur [0, size) (methode de Gray et al., reprise par YCSB). Le rang tire est
+ * ensuite disperse par un hachage pour que les cles chaudes ne soient pas voisines.
+ */
+void    zipfInit(Zipf *zipf, size_t size, double theta) {
+    size_t  i;
+
+    zipf->size = size;
+    zipf->theta = theta;
+    zipf->zetan = 0;
+    for (i = 1; i <= size; i++)
+        zipf->zetan += 1 / pow((double) i, theta);
+    zipf->alpha = 1 / (1 - theta);
+    zipf->eta = (1 - pow(2.0 / size, 1 - theta)) / (1 - (1 + pow(0.5, theta)) / zipf->zetan);
+}
+
+size_t  zipfNext(const Zipf *zipf, uint64_t *state) {
+    double      u = nextUniform(state);
+    double      uz = u * zipf->zetan;
+    size_t      rank;
+    uint64_t    hash;
+
+    if (uz < 1)
+        rank = 0;
+    else if (uz < 1 + pow(0.5, zipf->theta))
+        rank = 1;
+    else
+        rank = (size_t) (zipf->size * pow(zipf->eta * u - zipf->eta + 1, zipf->alpha));
+    if (rank >= zipf->size)
+        rank = zipf->size - 1;
+
+    hash = 0xCBF29CE484222325ull;
+    hash = (hash ^ rank) * 0x100000001B3ull;
+    hash = (hash ^ (rank >> 32)) * 0x100000001B3ull;
+    return hash % zipf->size;
+}
+
+//----------------------------------------
+/*
+ * Operations elementaires : la cle est copiee en tete de la donnee de 'elemSize' octets.
+ */
+void    opInsert(Bench *bench, size_t index) {
+    memcpy(bench->elem, &bench->keys[index], sizeof(int));
+    bench->tree = AVLtree_insertData3(bench->tree, compare3, bench->elem, bench->elemSize);
+}
+
+void    opDelete(Bench *bench, size_t index) {
+    bench->tree = AVLtree_deleteData3(bench->tree, compare3, &bench->keys[index]);
+}
+
+void    opSearch(Bench *bench, size_t index) {
+    bench->hits += AVLtree_search3(bench->tree, compare3, &bench->queries[index]) != NULL;
+}
+
+void    opTraverse(Bench *bench, size_t index) {
+    if (!AVLcursor_next(&bench->cursor))
+        AVLcursor_first(&bench->cursor);
+    bench->hits += AVLcursor_valid(&bench->cursor);
+}
+
+/*
+ * Une operation sur 20 insere une nouvelle cle (au-dela de 'size'), une autre supprime
+ * la cle tiree, les autres sont des recherches.
+ */
+void    opMixed(Bench *bench, size_t index) {
+    int key;
+
+    switch (index % 20) {
+    case 0:
+        key = (int) (bench->size + index);
+        memcpy(bench->elem, &key, sizeof(int));
+        bench->tree = AVLtree_insertData3(bench->tree, compare3, bench->elem, bench->elemSize);
+        break;
+    case 1:
+        bench->tree = AVLtree_deleteData3(bench->tree, compare3, &bench->queries[index]);
+        break;
+    default:
+        opSearch(bench, index);
+    }
+}
+
+//----------------------------------------
+int     compareDouble(const void * a, const void * b) {
+    double x = *(const double *) a, y = *(const double *) b;
+
+    return (x > y) - (x < y);
+}
+
+double  percentile(const double *sorted, size_t count, double p) {
+    if (!count)
+        return 0;
+    return sorted[(size_t) (p * (count - 1))];
+}
+
+long    peakRssKB(void) {
+    struct rusage usage;
+
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+/*
+ * Octets occupes dans le tas : exact avec la glibc, sinon approche par la memoire
+ * residente du processus.
+ */
+size_t  heapBytes(void) {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return mallinfo2().uordblks;
+#else
+    FILE    *statm = fopen("/proc/self/statm", "r");
+    size_t  pages = 0, resident = 0;
+
+    if (statm) {
+        if (fscanf(statm, "%zu %zu", &pages, &resident) != 2)
+            resident = 0;
+        fclose(statm);
+    }
+    return resident * 4096;
+#endif
+}
+
+/*
+ * Execute 'count' operations et ecrit l'objet JSON du resultat.
+ */
+void    run(FILE *out, bool *first, const char *name, Bench *bench, BenchOp op, size_t count, double *samples) {
+    size_t  stride = count / BENCH_SAMPLES + 1;
+    size_t  nbSamples = 0;
+    size_t  i;
+    double  start, elapsed, t0;
+
+    bench->hits = 0;
+    start = nowNanos();
+    for (i = 0; i < count; i++) {
+        if (i % stride == 0) {
+            t0 = nowNanos();
+            op(bench, i);
+            samples[nbSamples++] = nowNanos() - t0;
+        } else
+            op(bench, i);
+    }
+    elapsed = nowNanos() - start;
+    qsort(samples, nbSamples, sizeof(double), compareDouble);
+
+    fprintf(stderr, "  %-18s %12.0f ops/s\n", name, count / (elapsed * 1e-9));
+    fprintf(out, "%s\n        {\"workload\": \"%s\", \"ops\": %zu, \"hits\": %zu, \"seconds\": %.6f, "
+                 "\"opsPerSec\": %.0f, \"latencyNs\": {\"p50\": %.0f, \"p90\": %.0f, \"p99\": %.0f, "
+                 "\"p999\": %.0f, \"max\": %.0f}}",
+            *first ? "" : ",", name, count, bench->hits, elapsed * 1e-9, count / (elapsed * 1e-9),
+            percentile(samples, nbSamples, 0.5), percentile(samples, nbSamples, 0.9),
+            percentile(samples, nbSamples, 0.99), percentile(samples, nbSamples, 0.999),
+            nbSamples ? samples[nbSamples - 1] : 0);
+    *first = false;
+}
+
+/*
+ * Toutes les charges pour un arbre de 'size' cles et des donnees de 'payload' octets.
+ */
+bool    runGroup(FILE *out, size_t size, size_t payload, size_t maxOps, double *samples) {
+    Bench       bench;
+    Zipf        zipf;
+    uint64_t    state = 42;
+    size_t      i, ops, heapBefore, heapAfter;
+    bool        first = true;
+
+    bench.tree = NULL;
+    bench.size = size;
+    bench.elemSize = (payload < sizeof(int)) ? sizeof(int) : payload;
+    bench.elem = (char *) calloc(1, bench.elemSize);
+    bench.keys = (int *) malloc(sizeof(int) * size);
+    ops = (size < maxOps) ? size : maxOps;
+    bench.queries = (int *) malloc(sizeof(int) * ops);
+    if (!bench.elem || !bench.keys || !bench.queries)
+        return false;
+
+    fprintf(stderr, "%zu cles, donnees de %zu octets\n", size, bench.elemSize);
+    fprintf(out, "    {\"keys\": %zu, \"payload\": %zu, \"nodeSize\": %zu, \"workloads\": [",
+            size, bench.elemSize, AVLtree_nodeSize(bench.elemSize));
+
+    for (i = 0; i < size; i++)
+        bench.keys[i] = (int) i;
+    run(out, &first, "insert_sequential", &bench, opInsert, size, samples);
+    AVLtree_deleteTree(&bench.tree);
+
+    shuffle(bench.keys, size, &state);
+    heapBefore = heapBytes();
+    run(out, &first, "insert_random", &bench, opInsert, size, samples);
+    heapAfter = heapBytes();
+
+    for (i = 0; i < ops; i++)
+        bench.queries[i] = (int) (nextRandom(&state) % size);
+    run(out, &first, "search_random", &bench, opSearch, ops, samples);
+
+    zipfInit(&zipf, size, BENCH_ZIPF_THETA);
+    for (i = 0; i < ops; i++)
+        bench.queries[i] = (int) zipfNext(&zipf, &state);
+    run(out, &first, "search_zipfian", &bench, opSearch, ops, samples);
+
+    AVLcursor_init(&bench.cursor, bench.tree);
+    AVLcursor_first(&bench.cursor);
+    run(out, &first, "traversal", &bench, opTraverse, size, samples);
+
+    run(out, &first, "mixed", &bench, opMixed, ops, samples);
+
+    shuffle(bench.keys, size, &state);
+    run(out, &first, "delete_random", &bench, opDelete, size, samples);
+    AVLtree_deleteTree(&bench.tree);
+
+    fprintf(out, "\n      ], \"bytesPerNode\": %.1f, \"peakRssKB\": %ld}",
+            (heapAfter > heapBefore) ? (double) (heapAfter - heapBefore) / size : 0.0, peakRssKB());
+
+    free(bench.elem);
+    free(bench.keys);
+    free(bench.queries);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    size_t      maxKeys = 1000000;
+    size_t      maxOps = 1000000;
+    size_t      payloads[16] = { 4, 32, 256 };
+    size_t      nbPayloads = 3;
+    FILE        *out = stdout;
+    double      *samples;
+    char        *list;
+    size_t      size, p;
+    int         arg;
+
+    for (arg = 1; arg + 1 < argc; arg += 2) {
+        if (!strcmp(argv[arg], "-n"))
+            maxKeys = strtoul(argv[arg + 1], NULL, 10);
+        else if (!strcmp(argv[arg], "-q"))
+            maxOps = strtoul(argv[arg + 1], NULL, 10);
+        else if (!strcmp(argv[arg], "-p"))
+            for (nbPayloads = 0, list = argv[arg + 1]; *list && nbPayloads < 16; nbPayloads++) {
+                payloads[nbPayloads] = strtoul(list, &list, 10);
+                list += (*list == ',');
+            }
+        else if (!strcmp(argv[arg], "-o")) {
+            if (!(out = fopen(argv[arg + 1], "w"))) {
+                perror(argv[arg + 1]);
+                return EXIT_FAILURE;
+            }
+        } else
+            break;
+    }
+    if (arg < argc || maxKeys > BENCH_MAX_KEYS || !maxOps) {
+        fprintf(stderr, "usage : %s [-n max cles <= 10^8] [-q max operations] [-p 4,32,256] [-o fichier]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (!(samples = (double *) malloc(sizeof(double) * (BENCH_SAMPLES + 1))))
+        return EXIT_FAILURE;
+
+    fprintf(out, "{\n  \"compiler\": \"%s\",\n  \"optimized\": %s,\n  \"orderStatistic\": %s,\n  \"groups\": [\n",
+#if defined(__VERSION__)
+            __VERSION__,
+#else
+            "unknown",
+#endif
+#if defined(__OPTIMIZE__)
+            "true",
+#else
+            "false",
+#endif
+            AVLTREE_ORDER_STATISTIC ? "true" : "false");
+    for (p = 0; p < nbPayloads; p++)
+        for (size = 1000; size <= maxKeys; size *= 10) {
+            if (p || size > 1000)
+                fprintf(out, ",\n");
+            if (!runGroup(out, size, payloads[p], maxOps, samples))
+                return EXIT_FAILURE;
+        }
+    fprintf(out, "\n  ]\n}\n");
+
+    if (out != stdout)
+        fclose(out);
+    free(samples);
+    return EXIT_SUCCESS;
+}
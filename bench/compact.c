@@ -0,0 +1,96 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "avltree.h"
+#include "avlcompact.h"
+
+/*
+ * Compare l'arbre generique et l'arbre compact sur des cles entieres : octets occupes
+ * par element (tas mesure avec la glibc) et temps d'insertion et de recherche.
+ * Usage : compact [nombre de cles]
+ */
+
+int     compare3(const void * a, const void * b) {
+    return (*(int*)a > *(int*)b) - (*(int*)a < *(int*)b);
+}
+
+double  nowSeconds(void) {
+    struct timespec ts;
+
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+size_t  heapBytes(void) {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+
+    //les gros blocs (tableau compact) sont pris par mmap et comptes a part
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+int main(int argc, char **argv) {
+    size_t      size = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1 << 20;
+    int         *keys;
+    AVLTree     racine = NULL;
+    AVLCompact  tree;
+    size_t      i, j, found, heap, genericBytes, compactBytes;
+    double      start, insertGeneric, insertCompact, searchGeneric, searchCompact;
+    int         swap;
+
+    if (!(keys = (int *) malloc(sizeof(int) * size)) || !AVLcompact_init(&tree, sizeof(int), compare3))
+        return EXIT_FAILURE;
+    srand(42);
+    for (i = 0; i < size; i++)
+        keys[i] = (int) i;
+    for (i = size; i > 1; i--) {
+        j = ((size_t) rand() * RAND_MAX + rand()) % i;
+        swap = keys[i - 1];
+        keys[i - 1] = keys[j];
+        keys[j] = swap;
+    }
+
+    heap = heapBytes();
+    start = nowSeconds();
+    for (i = 0; i < size; i++)
+        racine = AVLtree_insertData3(racine, compare3, &keys[i], sizeof(int));
+    insertGeneric = nowSeconds() - start;
+    genericBytes = heapBytes() - heap;
+
+    heap = heapBytes();
+    start = nowSeconds();
+    for (i = 0; i < size; i++)
+        AVLcompact_insert(&tree, &keys[i]);
+    insertCompact = nowSeconds() - start;
+    compactBytes = heapBytes() - heap;
+
+    start = nowSeconds();
+    for (found = 0, i = 0; i < size; i++)
+        found += AVLtree_search3(racine, compare3, &keys[size - 1 - i]) != NULL;
+    searchGeneric = nowSeconds() - start;
+    start = nowSeconds();
+    for (found = 0, i = 0; i < size; i++)
+        found += AVLcompact_search(&tree, &keys[size - 1 - i]) != NULL;
+    searchCompact = nowSeconds() - start;
+
+    printf("%zu cles (%zu trouvees)\n", size, found);
+    printf("octets/element   generique %6.1f   compact %6.1f   x%.2f (noeud compact %zu octets, x%.2f apres reserve)\n",
+           (double) genericBytes / size, (double) compactBytes / size, (double) genericBytes / compactBytes,
+           AVLcompact_nodeSize(sizeof(int)), (double) genericBytes / size / AVLcompact_nodeSize(sizeof(int)));
+    printf("insert ns/op     generique %6.1f   compact %6.1f   x%.2f\n",
+           insertGeneric * 1e9 / size, insertCompact * 1e9 / size, insertGeneric / insertCompact);
+    printf("search ns/op     generique %6.1f   compact %6.1f   x%.2f\n",
+           searchGeneric * 1e9 / size, searchCompact * 1e9 / size, searchGeneric / searchCompact);
+
+    AVLtree_deleteTree(&racine);
+    AVLcompact_destroy(&tree);
+    free(keys);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,109 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "avltree.h"
+#include "avlfrozen.h"
+
+/*
+ * Compare la recherche dans un arbre AVL (AVLtree_search) et dans sa copie figee
+ * (AVLtree_freeze) : recherche generique, recherche d'entiers et recherche par lots SIMD.
+ * Usage : frozen [nombre d'elements] [nombre de recherches]
+ * Pour mesurer l'effet des defauts de cache, prendre un arbre plus gros que le dernier
+ * niveau de cache (environ 48 octets par noeud avec malloc).
+ */
+
+#define BATCH   64
+
+bool    compare(const void * a, const void * b) {
+    return *(int*)a < *(int*)b;
+}
+
+int     compare3(const void * a, const void * b) {
+    return (*(int*)a > *(int*)b) - (*(int*)a < *(int*)b);
+}
+
+double  nowSeconds(void) {
+    struct timespec ts;
+
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void    report(const char *name, double seconds, size_t nbQueries, size_t found, double reference) {
+    printf("%-28s %8.1f ns/recherche  x%-5.2f (%zu trouves)\n",
+           name, seconds * 1e9 / nbQueries, reference / seconds, found);
+}
+
+int main(int argc, char **argv) {
+    size_t      size = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1 << 20;
+    size_t      nbQueries = (argc > 2) ? strtoul(argv[2], NULL, 10) : 1 << 21;
+    int         *values, *queries;
+    void        *results[BATCH];
+    AVLTree     racine = NULL;
+    AVLFrozen   frozen;
+    size_t      i, j, found;
+    double      start, reference, seconds;
+    int         swap;
+
+    values = (int *) malloc(sizeof(int) * size);
+    queries = (int *) malloc(sizeof(int) * nbQueries);
+    if (!values || !queries)
+        return EXIT_FAILURE;
+
+    //insertion dans le desordre : les noeuds sont disperses dans le tas
+    srand(42);
+    for (i = 0; i < size; i++)
+        values[i] = (int) (2 * i);
+    for (i = size; i > 1; i--) {
+        j = ((size_t) rand() * RAND_MAX + rand()) % i;
+        swap = values[i - 1];
+        values[i - 1] = values[j];
+        values[j] = swap;
+    }
+    for (i = 0; i < size; i++)
+        racine = AVLtree_insertData3(racine, compare3, &values[i], sizeof(int));
+    //une recherche sur deux aboutit
+    for (i = 0; i < nbQueries; i++)
+        queries[i] = (int) (((size_t) rand() * RAND_MAX + rand()) % (2 * size));
+
+    start = nowSeconds();
+    if (!AVLtree_freeze(racine, &frozen, sizeof(int), sizeof(int), compare3))
+        return EXIT_FAILURE;
+    printf("%zu elements, %zu recherches, gel en %.3f s\n", size, nbQueries, nowSeconds() - start);
+
+    start = nowSeconds();
+    for (found = 0, i = 0; i < nbQueries; i++)
+        found += AVLtree_search(racine, compare, &queries[i]) != NULL;
+    reference = nowSeconds() - start;
+    report("AVLtree_search", reference, nbQueries, found, reference);
+
+    start = nowSeconds();
+    for (found = 0, i = 0; i < nbQueries; i++)
+        found += AVLfrozen_search(&frozen, &queries[i]) != NULL;
+    seconds = nowSeconds() - start;
+    report("AVLfrozen_search", seconds, nbQueries, found, reference);
+
+    start = nowSeconds();
+    for (found = 0, i = 0; i < nbQueries; i++)
+        found += AVLfrozen_searchInt(&frozen, queries[i]) != NULL;
+    seconds = nowSeconds() - start;
+    report("AVLfrozen_searchInt", seconds, nbQueries, found, reference);
+
+    start = nowSeconds();
+    for (found = 0, i = 0; i < nbQueries; i += j) {
+        j = (nbQueries - i < BATCH) ? nbQueries - i : BATCH;
+        AVLfrozen_searchIntBatch(&frozen, &queries[i], j, results);
+        while (j--)
+            found += results[j] != NULL;
+        j = (nbQueries - i < BATCH) ? nbQueries - i : BATCH;
+    }
+    seconds = nowSeconds() - start;
+    report("AVLfrozen_searchIntBatch", seconds, nbQueries, found, reference);
+
+    AVLfrozen_destroy(&frozen);
+    AVLtree_deleteTree(&racine);
+    free(values);
+    free(queries);
+    return EXIT_SUCCESS;
+}
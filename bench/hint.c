@@ -0,0 +1,127 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "avltree.h"
+#include "avlhandle.h"
+
+/*
+ * Compare l'insertion depuis la racine (AVLtree_insertData3, AVLhandle_insert) et depuis
+ * le doigt de la derniere insertion (AVLhandle_insertHint) sur des cles croissantes,
+ * presque triees (une cle sur dix echangee avec une voisine proche) et aleatoires.
+ * Les cles sont des entiers, puis des horodatages textuels de 32 octets, dont la
+ * comparaison coute plus cher.
+ * Usage : hint [nombre d'elements]
+ */
+
+#define STAMP_SIZE  32
+
+static unsigned long    nbCompare;
+
+int     compareInt(const void * a, const void * b) {
+    nbCompare++;
+    return (*(int*)a > *(int*)b) - (*(int*)a < *(int*)b);
+}
+
+int     compareStamp(const void * a, const void * b) {
+    nbCompare++;
+    return strcmp((const char*)a, (const char*)b);
+}
+
+double  nowSeconds(void) {
+    struct timespec ts;
+
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void    report(const char *workload, const char *name, double seconds, size_t size, double reference) {
+    printf("%-20s %-22s %7.1f ns/insertion  %5.1f comparaisons  x%.2f\n", workload, name,
+           seconds * 1e9 / size, (double) nbCompare / size, reference / seconds);
+}
+
+void    run(const char *workload, const char *keys, size_t keySize, size_t size,
+            int (*cmp3)(const void *, const void *)) {
+    AVLHandle   handle;
+    AVLTree     racine = NULL;
+    double      start, reference, seconds;
+    size_t      i;
+
+    nbCompare = 0;
+    start = nowSeconds();
+    for (i = 0; i < size; i++)
+        racine = AVLtree_insertData3(racine, cmp3, keys + i * keySize, keySize);
+    reference = nowSeconds() - start;
+    report(workload, "AVLtree_insertData3", reference, size, reference);
+    AVLtree_deleteTree(&racine);
+
+    AVLhandle_init(&handle, keySize, cmp3, NULL);
+    nbCompare = 0;
+    start = nowSeconds();
+    for (i = 0; i < size; i++)
+        AVLhandle_insert(&handle, keys + i * keySize);
+    seconds = nowSeconds() - start;
+    report(workload, "AVLhandle_insert", seconds, size, reference);
+    AVLhandle_destroy(&handle);
+
+    nbCompare = 0;
+    start = nowSeconds();
+    for (i = 0; i < size; i++)
+        AVLhandle_insertHint(&handle, NULL, keys + i * keySize);
+    seconds = nowSeconds() - start;
+    report(workload, "AVLhandle_insertHint", seconds, size, reference);
+    AVLhandle_destroy(&handle);
+}
+
+/*
+ * Echange une cle sur dix avec une voisine (presque trie) ou toutes (aleatoire).
+ */
+void    shuffle(char *keys, size_t keySize, size_t size, bool nearby) {
+    char    swap[STAMP_SIZE];
+    size_t  i, j;
+
+    srand(42);
+    for (i = 0; i + 8 < size; i++) {
+        if (nearby && rand() % 10)
+            continue;
+        j = (nearby) ? i + 1 + rand() % 8 : i + ((size_t) rand() * RAND_MAX + rand()) % (size - i);
+        memcpy(swap, keys + i * keySize, keySize);
+        memcpy(keys + i * keySize, keys + j * keySize, keySize);
+        memcpy(keys + j * keySize, swap, keySize);
+    }
+}
+
+int main(int argc, char **argv) {
+    size_t  size = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1 << 20;
+    size_t  i;
+    int     *ints;
+    char    *stamps;
+
+    ints = (int *) malloc(sizeof(int) * size);
+    stamps = (char *) malloc(STAMP_SIZE * size);
+    if (!ints || !stamps)
+        return EXIT_FAILURE;
+
+    for (i = 0; i < size; i++) {
+        ints[i] = (int) i;
+        snprintf(stamps + i * STAMP_SIZE, STAMP_SIZE, "2026-10-16T%02zu:%02zu:%02zu.%06zu",
+                 i / 3600000000 % 24, i / 60000000 % 60, i / 1000000 % 60, i % 1000000);
+    }
+    run("int croissant", (char *) ints, sizeof(int), size, compareInt);
+    run("horodatage croissant", stamps, STAMP_SIZE, size, compareStamp);
+
+    shuffle((char *) ints, sizeof(int), size, true);
+    shuffle(stamps, STAMP_SIZE, size, true);
+    run("int presque trie", (char *) ints, sizeof(int), size, compareInt);
+    run("horodatage presque", stamps, STAMP_SIZE, size, compareStamp);
+
+    shuffle((char *) ints, sizeof(int), size, false);
+    shuffle(stamps, STAMP_SIZE, size, false);
+    run("int aleatoire", (char *) ints, sizeof(int), size, compareInt);
+    run("horodatage aleatoire", stamps, STAMP_SIZE, size, compareStamp);
+
+    free(ints);
+    free(stamps);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,94 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "avltree.h"
+#include "avlmapped.h"
+
+/*
+ * Compare deux facons de retrouver un arbre sauvegarde : reconstruire l'arbre en memoire
+ * a partir des donnees (AVLtree_insertData3), ou projeter le fichier ecrit par
+ * AVLmapped_write et chercher directement dans les pages projetees.
+ * Usage : mapped [nombre d'elements] [nombre de recherches] [fichier]
+ */
+
+int     compare3(const void * a, const void * b) {
+    return (*(int*)a > *(int*)b) - (*(int*)a < *(int*)b);
+}
+
+double  nowSeconds(void) {
+    struct timespec ts;
+
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+    size_t      size = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1 << 20;
+    size_t      nbQueries = (argc > 2) ? strtoul(argv[2], NULL, 10) : 1 << 20;
+    const char  *path = (argc > 3) ? argv[3] : "bench_mapped.avl";
+    int         *values, *queries;
+    AVLTree     racine = NULL, copy = NULL;
+    AVLMapped   mapped;
+    size_t      i, j, found;
+    double      start, rebuild, open, tree, file;
+    int         swap;
+
+    values = (int *) malloc(sizeof(int) * size);
+    queries = (int *) malloc(sizeof(int) * nbQueries);
+    if (!values || !queries)
+        return EXIT_FAILURE;
+
+    srand(42);
+    for (i = 0; i < size; i++)
+        values[i] = (int) (2 * i);
+    for (i = size; i > 1; i--) {
+        j = ((size_t) rand() * RAND_MAX + rand()) % i;
+        swap = values[i - 1];
+        values[i - 1] = values[j];
+        values[j] = swap;
+    }
+    for (i = 0; i < size; i++)
+        racine = AVLtree_insertData3(racine, compare3, &values[i], sizeof(int));
+    for (i = 0; i < nbQueries; i++)
+        queries[i] = (int) (((size_t) rand() * RAND_MAX + rand()) % (2 * size));
+
+    start = nowSeconds();
+    if (!AVLmapped_write(racine, sizeof(int), path))
+        return EXIT_FAILURE;
+    printf("%zu elements, %zu recherches, ecriture en %.3f s\n", size, nbQueries, nowSeconds() - start);
+
+    //chargement : reconstruction complete contre simple projection
+    start = nowSeconds();
+    for (i = 0; i < size; i++)
+        copy = AVLtree_insertData3(copy, compare3, &values[i], sizeof(int));
+    rebuild = nowSeconds() - start;
+    start = nowSeconds();
+    if (!AVLmapped_open(&mapped, path))
+        return EXIT_FAILURE;
+    open = nowSeconds() - start;
+    printf("%-28s %10.3f ms\n", "reconstruction", rebuild * 1e3);
+    printf("%-28s %10.3f ms  x%.0f\n", "AVLmapped_open", open * 1e3, rebuild / open);
+
+    //recherches (pages deja en cache systeme : le fichier vient d'etre ecrit)
+    start = nowSeconds();
+    for (found = 0, i = 0; i < nbQueries; i++)
+        found += AVLtree_search3(copy, compare3, &queries[i]) != NULL;
+    tree = nowSeconds() - start;
+    printf("%-28s %8.1f ns/recherche  (%zu trouves)\n", "AVLtree_search3", tree * 1e9 / nbQueries, found);
+    start = nowSeconds();
+    for (found = 0, i = 0; i < nbQueries; i++)
+        found += AVLmapped_search(&mapped, compare3, &queries[i]) != NULL;
+    file = nowSeconds() - start;
+    printf("%-28s %8.1f ns/recherche  (%zu trouves)  x%.2f\n", "AVLmapped_search", file * 1e9 / nbQueries, found, tree / file);
+
+    AVLmapped_close(&mapped);
+    remove(path);
+    AVLtree_deleteTree(&racine);
+    AVLtree_deleteTree(&copy);
+    free(values);
+    free(queries);
+    return EXIT_SUCCESS;
+}
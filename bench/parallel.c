@@ -0,0 +1,135 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "avltree.h"
+#include "avlparallel.h"
+
+/*
+ * Mesure le passage a l'echelle des reductions paralleles : somme des donnees
+ * (AVLtree_parallel_reduce) et copie triee dans un tableau (AVLtree_parallel_reduce_ordered)
+ * de 1 a 'max' threads, comparees a AVLtree_in_order.
+ * Usage : parallel [nombre d'elements] [nombre maximal de threads]
+ */
+
+typedef struct {
+    long long   sum;
+    size_t      count;
+} SumAcc;
+
+typedef struct {
+    int         *items;
+    size_t      count;
+    size_t      capacity;
+} ListAcc;
+
+int     compare3(const void * a, const void * b) {
+    return (*(int*)a > *(int*)b) - (*(int*)a < *(int*)b);
+}
+
+double  nowSeconds(void) {
+    struct timespec ts;
+
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//un peu de calcul par noeud, comme une vraie agregation
+void    sumMap(void * acc, const void * data, void * context) {
+    unsigned int value = (unsigned int) *(const int*)data;
+
+    value = (value ^ (value >> 16)) * 0x45d9f3bu;
+    ((SumAcc*)acc)->sum += value ^ (value >> 16);
+    ((SumAcc*)acc)->count++;
+    (void) context;
+}
+
+void    sumCombine(void * acc, void * other, void * context) {
+    ((SumAcc*)acc)->sum += ((SumAcc*)other)->sum;
+    ((SumAcc*)acc)->count += ((SumAcc*)other)->count;
+    (void) context;
+}
+
+void    sumInOrder(void * data, void * acc) {
+    sumMap(acc, data, NULL);
+}
+
+void    listAppend(ListAcc *list, const int *items, size_t count) {
+    if (list->count + count > list->capacity) {
+        list->capacity = 2 * (list->count + count);
+        if (!(list->items = (int*) realloc(list->items, sizeof(int) * list->capacity)))
+            exit(EXIT_FAILURE);
+    }
+    memcpy(list->items + list->count, items, sizeof(int) * count);
+    list->count += count;
+}
+
+void    listMap(void * acc, const void * data, void * context) {
+    listAppend((ListAcc*)acc, (const int*)data, 1);
+    (void) context;
+}
+
+void    listCombine(void * acc, void * other, void * context) {
+    listAppend((ListAcc*)acc, ((ListAcc*)other)->items, ((ListAcc*)other)->count);
+    free(((ListAcc*)other)->items);
+    (void) context;
+}
+
+int main(int argc, char **argv) {
+    size_t          size = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1 << 22;
+    unsigned int    maxThreads = (argc > 2) ? (unsigned int) strtoul(argv[2], NULL, 10) : 16;
+    AVLReduceOps    sumOps = { .accSize = sizeof(SumAcc), .map = sumMap, .combine = sumCombine };
+    AVLReduceOps    listOps = { .accSize = sizeof(ListAcc), .map = listMap, .combine = listCombine };
+    AVLTree         racine = NULL;
+    SumAcc          sum;
+    ListAcc         list;
+    unsigned int    threads;
+    double          start, reference, seconds;
+    size_t          i, j;
+    int             *values, swap;
+
+    if (!(values = (int *) malloc(sizeof(int) * size)))
+        return EXIT_FAILURE;
+    //insertion dans le desordre : les noeuds sont disperses dans le tas
+    srand(42);
+    for (i = 0; i < size; i++)
+        values[i] = (int) i;
+    for (i = size; i > 1; i--) {
+        j = ((size_t) rand() * RAND_MAX + rand()) % i;
+        swap = values[i - 1];
+        values[i - 1] = values[j];
+        values[j] = swap;
+    }
+    for (i = 0; i < size; i++)
+        racine = AVLtree_insertData3(racine, compare3, &values[i], sizeof(int));
+    free(values);
+    printf("%zu elements, hauteur %zu\n", size, AVLtree_getHeight(racine));
+
+    memset(&sum, 0, sizeof(sum));
+    start = nowSeconds();
+    AVLtree_in_order(racine, sumInOrder, &sum);
+    reference = nowSeconds() - start;
+    printf("%-34s %9.2f ms\n", "AVLtree_in_order", reference * 1e3);
+
+    for (threads = 1; threads <= maxThreads; threads *= 2) {
+        start = nowSeconds();
+        AVLtree_parallel_reduce(racine, &sumOps, &sum, threads);
+        seconds = nowSeconds() - start;
+        printf("reduce          %3u threads       %9.2f ms  x%.2f\n", threads, seconds * 1e3, reference / seconds);
+        if (sum.count != size)
+            return EXIT_FAILURE;
+    }
+    for (threads = 1; threads <= maxThreads; threads *= 2) {
+        start = nowSeconds();
+        AVLtree_parallel_reduce_ordered(racine, &listOps, &list, threads);
+        seconds = nowSeconds() - start;
+        printf("reduce_ordered  %3u threads       %9.2f ms  x%.2f\n", threads, seconds * 1e3, reference / seconds);
+        if (list.count != size)
+            return EXIT_FAILURE;
+        free(list.items);
+    }
+
+    AVLtree_deleteTree(&racine);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,140 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "avlsharded.h"
+
+/*
+ * Mesure le debit d'ecriture de l'ensemble reparti de 1 a 'max' threads : chaque thread
+ * tire des cles au hasard et les ajoute, ou les retire si elles sont deja presentes (une
+ * operation sur dix est une simple recherche).
+ * Configurations comparees : un seul shard (un arbre, un verrou), 64 shards par intervalles
+ * avec des bornes reparties d'avance, 64 shards par intervalles sans bornes (remplissage
+ * croissant, le reequilibrage doit etaler les donnees) et 64 shards par hachage. Les autres
+ * configurations sont remplies dans le desordre.
+ * Usage : sharded [nombre d'operations] [nombre maximal de threads]
+ */
+
+#define NB_SHARDS   64
+#define NB_KEYS     (1 << 19)
+
+typedef struct {
+    AVLSharded      *set;
+    size_t          nbOps;
+    unsigned int    seed;
+} WorkerArgs;
+
+int     compare3(const void * a, const void * b) {
+    return (*(int*)a > *(int*)b) - (*(int*)a < *(int*)b);
+}
+
+size_t  hashInt(const void * a) {
+    return (size_t) *(const int*)a;
+}
+
+double  nowSeconds(void) {
+    struct timespec ts;
+
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void    *worker(void *arg) {
+    WorkerArgs  *args = (WorkerArgs*)arg;
+    size_t      i;
+    int         key;
+
+    for (i = 0; i < args->nbOps; i++) {
+        key = rand_r(&args->seed) % (2 * NB_KEYS);
+        if (i % 10 == 0)
+            AVLsharded_search(args->set, &key, NULL);
+        else if (!AVLsharded_insert(args->set, &key))
+            AVLsharded_delete(args->set, &key);
+    }
+    return NULL;
+}
+
+void    run(const char *name, AVLSharded *set, bool ascending, size_t nbOps, unsigned int maxThreads) {
+    WorkerArgs      args[256];
+    pthread_t       threads[256];
+    unsigned int    nbThreads, index;
+    size_t          smallest, largest, size, i, j;
+    double          start, seconds, reference = 0;
+    int             *keys, swap;
+
+    //une cle sur deux, dans l'ordre croissant ou melangees
+    if (!(keys = (int *) malloc(sizeof(int) * NB_KEYS)))
+        exit(EXIT_FAILURE);
+    for (i = 0; i < NB_KEYS; i++)
+        keys[i] = (int) (2 * i);
+    srand(42);
+    for (i = NB_KEYS; !ascending && i > 1; i--) {
+        j = ((size_t) rand() * RAND_MAX + rand()) % i;
+        swap = keys[i - 1];
+        keys[i - 1] = keys[j];
+        keys[j] = swap;
+    }
+    start = nowSeconds();
+    for (i = 0; i < NB_KEYS; i++)
+        AVLsharded_insert(set, &keys[i]);
+    seconds = nowSeconds() - start;
+    free(keys);
+    smallest = SIZE_MAX;
+    largest = 0;
+    for (index = 0; index < set->nbShards; index++) {
+        size = AVLsharded_getShardSize(set, index);
+        smallest = (size < smallest) ? size : smallest;
+        largest = (size > largest) ? size : largest;
+    }
+    printf("%s : %u shard(s), remplissage %s en %.2f ms, de %zu a %zu elements par shard, %zu reequilibrage(s)\n",
+           name, set->nbShards, (ascending) ? "croissant" : "melange", seconds * 1e3, smallest, largest,
+           AVLsharded_getRebalances(set));
+
+    for (nbThreads = 1; nbThreads <= maxThreads && nbThreads <= 256; nbThreads *= 2) {
+        for (index = 0; index < nbThreads; index++)
+            args[index] = (WorkerArgs) { set, nbOps / nbThreads, index + 1 };
+        start = nowSeconds();
+        for (index = 0; index < nbThreads; index++)
+            pthread_create(&threads[index], NULL, worker, &args[index]);
+        for (index = 0; index < nbThreads; index++)
+            pthread_join(threads[index], NULL);
+        seconds = nowSeconds() - start;
+        if (nbThreads == 1)
+            reference = seconds;
+        printf("    %3u threads  %9.2f ms  %6.2f Mop/s  x%.2f\n", nbThreads, seconds * 1e3,
+               nbOps / seconds * 1e-6, reference / seconds);
+    }
+    AVLsharded_destroy(set);
+}
+
+int main(int argc, char **argv) {
+    size_t          nbOps = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1 << 18;
+    unsigned int    maxThreads = (argc > 2) ? (unsigned int) strtoul(argv[2], NULL, 10) : 64;
+    AVLSharded      set;
+    int             bounds[NB_SHARDS - 1];
+    unsigned int    index;
+
+    for (index = 0; index < NB_SHARDS - 1; index++)
+        bounds[index] = (int) ((index + 1) * (2 * NB_KEYS / NB_SHARDS));
+
+    if (!AVLsharded_init(&set, 1, sizeof(int), compare3, NULL, 0))
+        return EXIT_FAILURE;
+    run("un verrou", &set, false, nbOps, maxThreads);
+
+    if (!AVLsharded_init(&set, NB_SHARDS, sizeof(int), compare3, bounds, NB_SHARDS - 1))
+        return EXIT_FAILURE;
+    run("intervalles fixes", &set, false, nbOps, maxThreads);
+
+    if (!AVLsharded_init(&set, NB_SHARDS, sizeof(int), compare3, NULL, 0))
+        return EXIT_FAILURE;
+    run("intervalles adaptatifs", &set, true, nbOps, maxThreads);
+
+    if (!AVLsharded_initHash(&set, NB_SHARDS, sizeof(int), compare3, hashInt))
+        return EXIT_FAILURE;
+    run("hachage", &set, false, nbOps, maxThreads);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,84 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "avltree.h"
+#include "avlreclaim.h"
+
+/*
+ * Mesure la pause imposee a l'appelant par la destruction d'un arbre : AVLtree_deleteTree
+ * d'un bloc, AVLteardown_step par tranches (pire tranche et duree totale) et
+ * AVLreclaimer_submit (duree de l'appel, puis attente de la liberation en arriere-plan).
+ * Usage : teardown [nombre d'elements] [budget par etape]
+ */
+
+int     compare3(const void * a, const void * b) {
+    return (*(int*)a > *(int*)b) - (*(int*)a < *(int*)b);
+}
+
+double  nowSeconds(void) {
+    struct timespec ts;
+
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//insertion dans le desordre : les noeuds sont disperses dans le tas
+AVLTree randomTree(size_t size) {
+    AVLTree racine = NULL;
+    size_t  i;
+    int     value;
+
+    srand(42);
+    for (i = 0; i < size; i++) {
+        value = (int) (((size_t) rand() * RAND_MAX + rand()) % (4 * size));
+        racine = AVLtree_insertData3(racine, compare3, &value, sizeof(int));
+    }
+    return racine;
+}
+
+int main(int argc, char **argv) {
+    size_t          size = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1 << 22;
+    size_t          budget = (argc > 2) ? strtoul(argv[2], NULL, 10) : 1000;
+    AVLTeardown     teardown;
+    AVLReclaimer    *reclaimer;
+    AVLTree         racine;
+    double          start, stepStart, worst, total;
+    size_t          steps, count;
+
+    racine = randomTree(size);
+    count = AVLtree_getSize(racine);
+    start = nowSeconds();
+    AVLtree_deleteTree(&racine);
+    total = nowSeconds() - start;
+    printf("%zu elements, budget de %zu etapes\n", count, budget);
+    printf("%-28s pause %10.3f ms\n", "AVLtree_deleteTree", total * 1e3);
+
+    racine = randomTree(size);
+    AVLteardown_init(&teardown, &racine, NULL);
+    worst = 0;
+    steps = 0;
+    start = nowSeconds();
+    do {
+        stepStart = nowSeconds();
+        steps++;
+        if (!AVLteardown_step(&teardown, budget))
+            break;
+        stepStart = nowSeconds() - stepStart;
+        worst = (stepStart > worst) ? stepStart : worst;
+    } while (1);
+    total = nowSeconds() - start;
+    printf("%-28s pause %10.3f ms  (%zu etapes, total %.3f ms)\n", "AVLteardown_step", worst * 1e3, steps, total * 1e3);
+
+    if (!(reclaimer = AVLreclaimer_create()))
+        return EXIT_FAILURE;
+    racine = randomTree(size);
+    start = nowSeconds();
+    AVLreclaimer_submit(reclaimer, &racine);
+    worst = nowSeconds() - start;
+    AVLreclaimer_wait(reclaimer);
+    total = nowSeconds() - start;
+    printf("%-28s pause %10.3f ms  (liberation en %.3f ms)\n", "AVLreclaimer_submit", worst * 1e3, total * 1e3);
+    AVLreclaimer_destroy(reclaimer);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,83 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "avltree.h"
+#include "avltyped.h"
+
+/*
+ * Compare l'API generique (comparateur par pointeur de fonction, donnee copiee dans
+ * 'char data[]') et un arbre type genere par DEFINE_AVLTREE sur des cles entieres.
+ * Usage : typed [nombre de cles]
+ */
+
+DEFINE_AVLTREE(IntTree, int, AVLTYPED_CMP)
+
+int     compare3(const void * a, const void * b) {
+    return (*(int*)a > *(int*)b) - (*(int*)a < *(int*)b);
+}
+
+double  nowSeconds(void) {
+    struct timespec ts;
+
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void    report(const char *name, double generic, double typed, size_t count, size_t found) {
+    printf("%-8s generique %7.1f ns/op   type %7.1f ns/op   x%.2f (%zu)\n",
+           name, generic * 1e9 / count, typed * 1e9 / count, generic / typed, found);
+}
+
+int main(int argc, char **argv) {
+    size_t      size = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1 << 20;
+    int         *keys;
+    AVLTree     racine = NULL;
+    IntTreeNode *typed = NULL;
+    size_t      i, j, found;
+    double      start, generic;
+    int         swap;
+
+    if (!(keys = (int *) malloc(sizeof(int) * size)))
+        return EXIT_FAILURE;
+    srand(42);
+    for (i = 0; i < size; i++)
+        keys[i] = (int) i;
+    for (i = size; i > 1; i--) {
+        j = ((size_t) rand() * RAND_MAX + rand()) % i;
+        swap = keys[i - 1];
+        keys[i - 1] = keys[j];
+        keys[j] = swap;
+    }
+    printf("%zu cles\n", size);
+
+    start = nowSeconds();
+    for (i = 0; i < size; i++)
+        racine = AVLtree_insertData3(racine, compare3, &keys[i], sizeof(int));
+    generic = nowSeconds() - start;
+    start = nowSeconds();
+    for (i = 0; i < size; i++)
+        typed = IntTree_insert(typed, keys[i]);
+    report("insert", generic, nowSeconds() - start, size, size);
+
+    start = nowSeconds();
+    for (found = 0, i = 0; i < size; i++)
+        found += AVLtree_search3(racine, compare3, &keys[size - 1 - i]) != NULL;
+    generic = nowSeconds() - start;
+    start = nowSeconds();
+    for (found = 0, i = 0; i < size; i++)
+        found += IntTree_search(typed, keys[size - 1 - i]) != NULL;
+    report("search", generic, nowSeconds() - start, size, found);
+
+    start = nowSeconds();
+    for (i = 0; i < size; i++)
+        racine = AVLtree_deleteData3(racine, compare3, &keys[i]);
+    generic = nowSeconds() - start;
+    start = nowSeconds();
+    for (i = 0; i < size; i++)
+        typed = IntTree_delete(typed, keys[i]);
+    report("delete", generic, nowSeconds() - start, size, size);
+
+    free(keys);
+    return (racine || typed) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
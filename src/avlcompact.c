@@ -0,0 +1,357 @@
+#include <string.h>
+
+#include "avlcompact.h"
+
+
+#define AVLCOMPACT_ROUND(x, a)  (((x) + (a) - 1) / (a) * (a))
+
+#define NODE(tree, index)       ((AVLCompactNode *) ((tree)->nodes + (size_t) (index) * (tree)->stride))
+#define DATA(tree, index)       ((tree)->nodes + (size_t) (index) * (tree)->stride + (tree)->dataOffset)
+
+/*
+ * Alignement de la donnee : la plus grande puissance de deux (au plus 8) qui divise sa
+ * taille. Un entier est ainsi aligne sur 4 octets sans imposer 8 a tous les noeuds.
+ */
+static size_t AVLcompact_align(size_t elemSize) {
+    size_t align = 1;
+
+    while (align < 8 && !(elemSize % (align * 2)))
+        align *= 2;
+    return align;
+}
+
+/*
+ * Position de la donnee dans le noeud : apres toute la structure AVLCompactNode, y compris
+ * son remplissage final, que le compilateur peut ecraser en ecrivant un champ.
+ */
+static size_t AVLcompact_dataOffset(size_t elemSize) {
+    return AVLCOMPACT_ROUND(sizeof(AVLCompactNode), AVLcompact_align(elemSize));
+}
+
+/*
+ * Renvoie la place occupee dans le tableau par un noeud contenant 'elemSize' octets.
+ */
+size_t  AVLcompact_nodeSize(size_t elemSize) {
+    size_t align = AVLcompact_align(elemSize);
+
+    return AVLCOMPACT_ROUND(AVLcompact_dataOffset(elemSize) + elemSize,
+                            (align < _Alignof(AVLCompactNode)) ? _Alignof(AVLCompactNode) : align);
+}
+
+/*
+ * Initialise un arbre compact vide pour des donnees de 'elemSize' octets comparees avec
+ * 'cmp3'. Aucune memoire n'est allouee avant la premiere insertion.
+ */
+bool    AVLcompact_init(AVLCompact *tree, size_t elemSize, int (*cmp3)(const void *, const void *)) {
+    if (!tree || !elemSize || !cmp3)
+        return false;
+
+    tree->nodes = NULL;
+    tree->elemSize = elemSize;
+    tree->dataOffset = AVLcompact_dataOffset(elemSize);
+    tree->stride = AVLcompact_nodeSize(elemSize);
+    tree->root = AVLCOMPACT_NIL;
+    tree->capacity = 0;
+    tree->next = 1;
+    tree->freeList = AVLCOMPACT_NIL;
+    tree->nbNodes = 0;
+    tree->cmp3 = cmp3;
+    return true;
+}
+
+/*
+ * Libere le tableau de noeuds ; l'arbre redevient vide et reutilisable.
+ */
+void    AVLcompact_destroy(AVLCompact *tree) {
+    if (!tree)
+        return;
+    free(tree->nodes);
+    AVLcompact_init(tree, tree->elemSize, tree->cmp3);
+}
+
+/*
+ * Agrandit le tableau pour qu'il puisse contenir 'count' noeuds sans autre reallocation.
+ * La case 0 (NIL) n'est jamais utilisee.
+ */
+bool    AVLcompact_reserve(AVLCompact *tree, size_t count) {
+    char *grown;
+
+    if (count > AVLCOMPACT_MAX_NODES)
+        return false;
+    if (count + 1 <= tree->capacity)
+        return true;
+    if (!(grown = (char *) realloc(tree->nodes, (count + 1) * tree->stride)))
+        return false;
+    tree->nodes = grown;
+    tree->capacity = (uint32_t) (count + 1);
+    return true;
+}
+
+/*
+ * Garantit une case libre avant une insertion. Le tableau grandit de moitie a chaque
+ * fois, ce qui borne la place perdue sans multiplier les copies.
+ */
+static bool AVLcompact_grow(AVLCompact *tree) {
+    size_t count;
+
+    if (tree->freeList != AVLCOMPACT_NIL || tree->next < tree->capacity)
+        return true;
+    count = (size_t) tree->capacity + tree->capacity / 2 + 16;
+    if (count > AVLCOMPACT_MAX_NODES)
+        count = AVLCOMPACT_MAX_NODES;
+    return count + 1 > tree->capacity && AVLcompact_reserve(tree, count);
+}
+
+static uint32_t AVLcompact_alloc(AVLCompact *tree) {
+    uint32_t index;
+
+    if ((index = tree->freeList) != AVLCOMPACT_NIL)
+        tree->freeList = NODE(tree, index)->left;
+    else
+        index = tree->next++;
+    tree->nbNodes++;
+    return index;
+}
+
+static void AVLcompact_free(AVLCompact *tree, uint32_t index) {
+    NODE(tree, index)->left = tree->freeList;
+    tree->freeList = index;
+    tree->nbNodes--;
+}
+
+//----------------------------------------
+/*
+ * Acces au noeud et a la donnee d'indice 'index' (NULL pour NIL).
+ */
+AVLCompactNode  *AVLcompact_getNode(const AVLCompact *tree, uint32_t index) {
+    if (index == AVLCOMPACT_NIL)
+        return NULL;
+    return NODE(tree, index);
+}
+
+void    *AVLcompact_getData(const AVLCompact *tree, uint32_t index) {
+    if (index == AVLCOMPACT_NIL)
+        return NULL;
+    return DATA(tree, index);
+}
+
+/*
+ * Renvoie le nombre d'elements de l'arbre.
+ */
+size_t  AVLcompact_getSize(const AVLCompact *tree) {
+    return tree->nbNodes;
+}
+
+static inline int AVLcompact_height(const AVLCompact *tree, uint32_t index) {
+    return (index != AVLCOMPACT_NIL) ? NODE(tree, index)->height : 0;
+}
+
+/*
+ * Renvoie la hauteur de l'arbre.
+ */
+size_t  AVLcompact_getHeight(const AVLCompact *tree) {
+    return AVLcompact_height(tree, tree->root);
+}
+
+/*
+ * Renvoie la memoire reservee pour les noeuds, en octets.
+ */
+size_t  AVLcompact_getMemory(const AVLCompact *tree) {
+    return (size_t) tree->capacity * tree->stride;
+}
+
+//----------------------------------------
+/*
+ * Hauteurs et rotations sur les indices, memes conventions que avltree.c : rotateLeft
+ * remonte le fils gauche.
+ */
+static void AVLcompact_update(AVLCompact *tree, uint32_t index) {
+    AVLCompactNode  *node = NODE(tree, index);
+    int             left = AVLcompact_height(tree, node->left);
+    int             right = AVLcompact_height(tree, node->right);
+
+    node->height = (uint8_t) (((left > right) ? left : right) + 1);
+}
+
+static uint32_t AVLcompact_rotateLeft(AVLCompact *tree, uint32_t index) {
+    AVLCompactNode  *node = NODE(tree, index);
+    uint32_t        child = node->left;
+
+    node->left = NODE(tree, child)->right;
+    NODE(tree, child)->right = index;
+    AVLcompact_update(tree, index);
+    AVLcompact_update(tree, child);
+    return child;
+}
+
+static uint32_t AVLcompact_rotateRight(AVLCompact *tree, uint32_t index) {
+    AVLCompactNode  *node = NODE(tree, index);
+    uint32_t        child = node->right;
+
+    node->right = NODE(tree, child)->left;
+    NODE(tree, child)->left = index;
+    AVLcompact_update(tree, index);
+    AVLcompact_update(tree, child);
+    return child;
+}
+
+static uint32_t AVLcompact_rebalance(AVLCompact *tree, uint32_t index) {
+    AVLCompactNode  *node = NODE(tree, index);
+    int             balance;
+
+    balance = AVLcompact_height(tree, node->left) - AVLcompact_height(tree, node->right);
+    if (balance > 1) {
+        if (AVLcompact_height(tree, NODE(tree, node->left)->left) < AVLcompact_height(tree, NODE(tree, node->left)->right))
+            node->left = AVLcompact_rotateRight(tree, node->left);
+        return AVLcompact_rotateLeft(tree, index);
+    }
+    if (balance < -1) {
+        if (AVLcompact_height(tree, NODE(tree, node->right)->right) < AVLcompact_height(tree, NODE(tree, node->right)->left))
+            node->right = AVLcompact_rotateLeft(tree, node->right);
+        return AVLcompact_rotateRight(tree, index);
+    }
+    return index;
+}
+
+/*
+ * Remontee du chemin de liens 'path' depuis 'level', arretee des qu'une hauteur ne change
+ * plus (voir AVLtree_retrace). Les liens pointent dans le tableau : il ne doit pas etre
+ * realloue entre la descente et la remontee.
+ */
+static void AVLcompact_retrace(AVLCompact *tree, uint32_t **path, int level) {
+    uint32_t    index;
+    int         oldHeight;
+
+    for (; level >= 0; level--) {
+        index = *path[level];
+        oldHeight = NODE(tree, index)->height;
+        AVLcompact_update(tree, index);
+        index = AVLcompact_rebalance(tree, index);
+        *path[level] = index;
+        if (NODE(tree, index)->height == oldHeight)
+            break;
+    }
+}
+
+//----------------------------------------
+/*
+ * Renvoie la donnee egale a 'data', ou NULL.
+ */
+void    *AVLcompact_search(const AVLCompact *tree, const void *data) {
+    uint32_t    index = tree->root;
+    int         res;
+
+    while (index != AVLCOMPACT_NIL) {
+        if ((res = tree->cmp3(data, DATA(tree, index))) == 0)
+            return DATA(tree, index);
+        index = (res < 0) ? NODE(tree, index)->left : NODE(tree, index)->right;
+    }
+    return NULL;
+}
+
+/*
+ * Insere une copie de 'data'. La place est reservee avant la descente pour que le chemin
+ * reste valide. Renvoie false si la donnee est deja presente ou si la memoire manque.
+ */
+bool    AVLcompact_insert(AVLCompact *tree, const void *data) {
+    uint32_t        *path[AVLTREE_MAX_HEIGHT];
+    uint32_t        *link;
+    uint32_t        index;
+    AVLCompactNode  *node;
+    int             depth, res;
+
+    if (!AVLcompact_grow(tree))
+        return false;
+
+    depth = 0;
+    link = &tree->root;
+    while ((index = *link) != AVLCOMPACT_NIL) {
+        path[depth++] = link;
+        if ((res = tree->cmp3(data, DATA(tree, index))) == 0)
+            return false;
+        link = (res < 0) ? &NODE(tree, index)->left : &NODE(tree, index)->right;
+    }
+
+    index = AVLcompact_alloc(tree);
+    node = NODE(tree, index);
+    node->left = AVLCOMPACT_NIL;
+    node->right = AVLCOMPACT_NIL;
+    node->height = 1;
+    memcpy(DATA(tree, index), data, tree->elemSize);
+    *link = index;
+
+    AVLcompact_retrace(tree, path, depth - 1);
+    return true;
+}
+
+/*
+ * Supprime l'element egal a 'data' ; un noeud a deux fils est remplace par son successeur
+ * en modifiant les indices, sans recopier de donnee. Renvoie false si absent.
+ */
+bool    AVLcompact_delete(AVLCompact *tree, const void *data) {
+    uint32_t        *path[AVLTREE_MAX_HEIGHT + 1];
+    uint32_t        *link, *succLink;
+    uint32_t        index, succ;
+    AVLCompactNode  *node;
+    int             depth, res, level, start;
+
+    depth = 0;
+    link = &tree->root;
+    while ((index = *link) != AVLCOMPACT_NIL) {
+        path[depth++] = link;
+        if ((res = tree->cmp3(data, DATA(tree, index))) == 0)
+            break;
+        link = (res < 0) ? &NODE(tree, index)->left : &NODE(tree, index)->right;
+    }
+    if (index == AVLCOMPACT_NIL)
+        return false;
+
+    node = NODE(tree, index);
+    level = depth - 1;
+    if (node->left == AVLCOMPACT_NIL || node->right == AVLCOMPACT_NIL) {
+        *link = (node->left != AVLCOMPACT_NIL) ? node->left : node->right;
+        start = level - 1;
+    } else {
+        start = level + 1;
+        succLink = &node->right;
+        path[start] = succLink;
+        while (NODE(tree, *succLink)->left != AVLCOMPACT_NIL) {
+            succLink = &NODE(tree, *succLink)->left;
+            path[++start] = succLink;
+        }
+
+        succ = *succLink;
+        *succLink = NODE(tree, succ)->right;
+        NODE(tree, succ)->left = node->left;
+        NODE(tree, succ)->right = node->right;
+        NODE(tree, succ)->height = node->height;
+        *link = succ;
+        path[level + 1] = &NODE(tree, succ)->right;
+        start--;
+    }
+
+    AVLcompact_retrace(tree, path, start);
+    AVLcompact_free(tree, index);
+    return true;
+}
+
+//----------------------------------------
+/*
+ * Parcours infixe iteratif ; s'arrete des que 'func' renvoie false.
+ */
+void    AVLcompact_in_order(const AVLCompact *tree, bool (*func)(void *, void *), void *extra_data) {
+    uint32_t    stack[AVLTREE_MAX_HEIGHT];
+    uint32_t    index = tree->root;
+    int         depth = 0;
+
+    while (index != AVLCOMPACT_NIL || depth) {
+        while (index != AVLCOMPACT_NIL) {
+            stack[depth++] = index;
+            index = NODE(tree, index)->left;
+        }
+        index = stack[--depth];
+        if (!func(DATA(tree, index), extra_data))
+            return;
+        index = NODE(tree, index)->right;
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef _AVLCOMPACT_H_
+#define _AVLCOMPACT_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "avltree.h"
+
+
+/*
+ * Arbre AVL compact : tous les noeuds sont ranges dans un seul tableau extensible et se
+ * designent par leur indice sur 32 bits (0 tient lieu de NULL). L'entete d'un noeud est
+ * un AVLCompactNode de 12 octets (deux indices et une hauteur sur un octet, suffisante sous
+ * 2^32 noeuds, plus le remplissage), suivi de la donnee alignee : 16 octets par entier au
+ * lieu de 32 (48 avec malloc) pour 'struct AVLTreeNode'. La donnee ne commence jamais
+ * dans le remplissage de l'entete.
+ * Les noeuds supprimes sont chaines dans une liste libre (par 'left') et reutilises.
+ * Les pointeurs renvoyes par #AVLcompact_search() ne restent valides que jusqu'a la
+ * prochaine insertion, qui peut deplacer le tableau.
+ */
+#define AVLCOMPACT_NIL          0
+#define AVLCOMPACT_MAX_NODES    (UINT32_MAX - 1)
+
+typedef struct AVLCompactNode AVLCompactNode;
+struct          AVLCompactNode {
+        uint32_t        left;
+        uint32_t        right;
+        uint8_t         height;
+};
+
+typedef struct AVLCompact AVLCompact;
+struct          AVLCompact {
+        char            *nodes;
+        size_t          stride;
+        size_t          dataOffset;
+        size_t          elemSize;
+        uint32_t        root;
+        uint32_t        capacity;
+        uint32_t        next;
+        uint32_t        freeList;
+        uint32_t        nbNodes;
+        int             (*cmp3)(const void *, const void *);
+};
+
+/*--------------------------------------------------------------------*/
+bool    AVLcompact_init(AVLCompact *tree, size_t elemSize, int (*cmp3)(const void *, const void *));
+void    AVLcompact_destroy(AVLCompact *tree);
+bool    AVLcompact_reserve(AVLCompact *tree, size_t count);
+size_t  AVLcompact_nodeSize(size_t elemSize);
+
+//----------------------------------------
+AVLCompactNode  *AVLcompact_getNode(const AVLCompact *tree, uint32_t index);
+void    *AVLcompact_getData(const AVLCompact *tree, uint32_t index);
+size_t  AVLcompact_getSize(const AVLCompact *tree);
+size_t  AVLcompact_getHeight(const AVLCompact *tree);
+size_t  AVLcompact_getMemory(const AVLCompact *tree);
+
+//----------------------------------------
+void    *AVLcompact_search(const AVLCompact *tree, const void *data);
+bool    AVLcompact_insert(AVLCompact *tree, const void *data);
+bool    AVLcompact_delete(AVLCompact *tree, const void *data);
+
+//----------------------------------------
+void    AVLcompact_in_order(const AVLCompact *tree, bool (*func)(void *, void *), void *extra_data);
+/*--------------------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,213 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+
+#include "avlconcurrent.h"
+#include "avlcursor.h"
+
+
+/*
+ * Fonctions du moteur de copie : les noeuds sont alloues avec malloc() et un noeud
+ * abandonne par la nouvelle version est mis de cote avec l'epoque courante.
+ */
+static AVLTree AVLconcurrent_alloc(void *context) {
+    AVLConcurrent *tree = (AVLConcurrent *) context;
+
+    return (AVLTree) malloc(AVLtree_nodeSize(tree->ops.elemSize));
+}
+
+static void AVLconcurrent_retire(AVLTree node, void *context) {
+    AVLConcurrent   *tree = (AVLConcurrent *) context;
+    AVLRetired      *grown;
+    size_t          size;
+
+    if (tree->nbRetired == tree->maxRetired) {
+        size = (tree->maxRetired) ? tree->maxRetired * 2 : 64;
+        if (!(grown = (AVLRetired *) realloc(tree->retired, sizeof(AVLRetired) * size)))
+            abort();
+        tree->retired = grown;
+        tree->maxRetired = size;
+    }
+    tree->retired[tree->nbRetired++] = (AVLRetired) { node, atomic_load(&tree->epoch) };
+}
+
+/*
+ * Libere les noeuds mis de cote avant l'entree du plus ancien lecteur encore actif.
+ * Appele par l'ecrivain, verrou tenu, apres publication de la nouvelle racine.
+ */
+static void AVLconcurrent_reclaim(AVLConcurrent *tree) {
+    unsigned long   oldest, epoch;
+    size_t          index, kept;
+
+    oldest = atomic_fetch_add(&tree->epoch, 1) + 1;
+    for (index = 0; index < AVLCONCURRENT_MAX_READERS; index++) {
+        epoch = atomic_load(&tree->readers[index].epoch);
+        if (epoch && epoch < oldest)
+            oldest = epoch;
+    }
+
+    kept = 0;
+    for (index = 0; index < tree->nbRetired; index++) {
+        if (tree->retired[index].epoch < oldest)
+            free(tree->retired[index].node);
+        else
+            tree->retired[kept++] = tree->retired[index];
+    }
+    tree->nbRetired = kept;
+}
+
+//----------------------------------------
+/*
+ * Initialise un arbre concurrent vide pour des donnees de 'elemSize' octets.
+ */
+bool    AVLconcurrent_init(AVLConcurrent *tree, int (*cmp3)(const void *, const void *), size_t elemSize) {
+    size_t index;
+
+    if (!tree || !cmp3)
+        return false;
+
+    atomic_init(&tree->root, NULL);
+    atomic_init(&tree->epoch, 1);
+    pthread_mutex_init(&tree->writeLock, NULL);
+    tree->ops = (AVLCopyOps) {
+        .cmp3 = cmp3,
+        .elemSize = elemSize,
+        .alloc = AVLconcurrent_alloc,
+        .release = AVLconcurrent_retire,
+        .context = tree
+    };
+    tree->retired = NULL;
+    tree->nbRetired = 0;
+    tree->maxRetired = 0;
+    for (index = 0; index < AVLCONCURRENT_MAX_READERS; index++) {
+        atomic_init(&tree->readers[index].epoch, 0);
+        atomic_init(&tree->readers[index].used, false);
+    }
+    return true;
+}
+
+/*
+ * Libere l'arbre et les noeuds en attente. Plus aucun thread ne doit l'utiliser.
+ */
+void    AVLconcurrent_destroy(AVLConcurrent *tree) {
+    AVLTree root;
+    size_t  index;
+
+    root = atomic_load(&tree->root);
+    AVLtree_deleteSubtree(&root, NULL);
+    for (index = 0; index < tree->nbRetired; index++)
+        free(tree->retired[index].node);
+    free(tree->retired);
+    tree->retired = NULL;
+    tree->nbRetired = 0;
+    atomic_store(&tree->root, NULL);
+    pthread_mutex_destroy(&tree->writeLock);
+}
+
+//----------------------------------------
+/*
+ * Reserve un emplacement de lecteur pour le thread appelant. Un lecteur n'est utilise que
+ * par un thread a la fois. Renvoie NULL si tous les emplacements sont pris.
+ */
+AVLReader       *AVLconcurrent_registerReader(AVLConcurrent *tree) {
+    size_t  index;
+    bool    expected;
+
+    for (index = 0; index < AVLCONCURRENT_MAX_READERS; index++) {
+        expected = false;
+        if (atomic_compare_exchange_strong(&tree->readers[index].used, &expected, true))
+            return &tree->readers[index];
+    }
+    return NULL;
+}
+
+/*
+ * Rend un emplacement de lecteur.
+ */
+void            AVLconcurrent_unregisterReader(AVLReader *reader) {
+    atomic_store(&reader->epoch, 0);
+    atomic_store(&reader->used, false);
+}
+
+/*
+ * Entre en section de lecture et renvoie la racine de la version courante.
+ * Jusqu'a #AVLconcurrent_readEnd(), cette version peut etre parcourue librement avec les
+ * fonctions en lecture seule (search, curseurs, parcours) : aucun de ses noeuds ne sera
+ * modifie ni libere.
+ */
+AVLTree         AVLconcurrent_readBegin(AVLConcurrent *tree, AVLReader *reader) {
+    atomic_store(&reader->epoch, atomic_load(&tree->epoch));
+    return atomic_load(&tree->root);
+}
+
+/*
+ * Sort de la section de lecture : les noeuds lus ne doivent plus etre utilises.
+ */
+void            AVLconcurrent_readEnd(AVLReader *reader) {
+    atomic_store(&reader->epoch, 0);
+}
+
+//----------------------------------------
+/*
+ * Recherche sans verrou. Si 'data' est present et 'result' non nul, la donnee trouvee y
+ * est recopiee (le noeud lui-meme ne peut pas etre garde apres la lecture).
+ */
+bool    AVLconcurrent_search(AVLConcurrent *tree, AVLReader *reader, const void *data, void *result) {
+    AVLTree node;
+
+    node = AVLtree_search3(AVLconcurrent_readBegin(tree, reader), tree->ops.cmp3, data);
+    if (node && result)
+        memcpy(result, node->data, tree->ops.elemSize);
+    AVLconcurrent_readEnd(reader);
+    return node != NULL;
+}
+
+/*
+ * Parcours d'intervalle sans verrou sur une version coherente de l'arbre (voir
+ * #AVLtree_range()). 'func' est appele en section de lecture.
+ */
+size_t  AVLconcurrent_range(AVLConcurrent *tree, AVLReader *reader, const void *low, const void *high,
+                            bool (*func)(void *, void *), void *extra_data) {
+    size_t nbVisited;
+
+    nbVisited = AVLtree_range(AVLconcurrent_readBegin(tree, reader), tree->ops.cmp3, low, high, func, extra_data);
+    AVLconcurrent_readEnd(reader);
+    return nbVisited;
+}
+
+//----------------------------------------
+/*
+ * Insertion : construit la nouvelle version sous le verrou d'ecriture, la publie, puis
+ * libere ce qui peut l'etre. Renvoie false si 'data' etait deja present.
+ */
+bool    AVLconcurrent_insert(AVLConcurrent *tree, const void *data) {
+    AVLTree root;
+    bool    inserted;
+
+    pthread_mutex_lock(&tree->writeLock);
+    root = AVLcopy_insert(&tree->ops, atomic_load(&tree->root), data, &inserted);
+    if (inserted) {
+        atomic_store(&tree->root, root);
+        AVLconcurrent_reclaim(tree);
+    }
+    pthread_mutex_unlock(&tree->writeLock);
+    return inserted;
+}
+
+/*
+ * Suppression, meme principe que #AVLconcurrent_insert(). Renvoie false si 'data' etait
+ * absent.
+ */
+bool    AVLconcurrent_delete(AVLConcurrent *tree, const void *data) {
+    AVLTree root;
+    bool    deleted;
+
+    pthread_mutex_lock(&tree->writeLock);
+    root = AVLcopy_delete(&tree->ops, atomic_load(&tree->root), data, &deleted);
+    if (deleted) {
+        atomic_store(&tree->root, root);
+        AVLconcurrent_reclaim(tree);
+    }
+    pthread_mutex_unlock(&tree->writeLock);
+    return deleted;
+}
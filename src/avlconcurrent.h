@@ -0,0 +1,71 @@
+#ifndef _AVLCONCURRENT_H_
+#define _AVLCONCURRENT_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "avltree.h"
+#include "avlcopy.h"
+
+
+#define AVLCONCURRENT_MAX_READERS       128
+
+/*
+ * Emplacement de lecteur : l'epoque a laquelle le lecteur est entre en section de lecture,
+ * 0 s'il n'en a pas. Chaque emplacement occupe sa propre ligne de cache.
+ */
+typedef struct AVLReader AVLReader;
+struct          AVLReader {
+        _Alignas(64) atomic_ulong epoch;
+        atomic_bool     used;
+};
+
+typedef struct AVLRetired AVLRetired;
+struct          AVLRetired {
+        AVLTree         node;
+        unsigned long   epoch;
+};
+
+/*
+ * Arbre partage entre threads.
+ * Les lecteurs ne prennent aucun verrou : ils lisent la racine publiee et parcourent une
+ * version qui n'est plus jamais modifiee. Les ecrivains sont serialises par un verrou et
+ * publient une nouvelle racine construite par copie de chemin (voir avlcopy.h).
+ * Les noeuds remplaces ne sont liberes qu'une fois que plus aucun lecteur entre avant leur
+ * remplacement n'est en section de lecture (reclamation par epoques).
+ */
+typedef struct AVLConcurrent AVLConcurrent;
+struct          AVLConcurrent {
+        _Atomic(AVLTree)        root;
+        atomic_ulong            epoch;
+        pthread_mutex_t         writeLock;
+        AVLCopyOps              ops;
+        AVLRetired              *retired;
+        size_t                  nbRetired;
+        size_t                  maxRetired;
+        AVLReader               readers[AVLCONCURRENT_MAX_READERS];
+};
+
+/*--------------------------------------------------------------------*/
+bool    AVLconcurrent_init(AVLConcurrent *tree, int (*cmp3)(const void *, const void *), size_t elemSize);
+void    AVLconcurrent_destroy(AVLConcurrent *tree);
+
+//----------------------------------------
+AVLReader       *AVLconcurrent_registerReader(AVLConcurrent *tree);
+void            AVLconcurrent_unregisterReader(AVLReader *reader);
+AVLTree         AVLconcurrent_readBegin(AVLConcurrent *tree, AVLReader *reader);
+void            AVLconcurrent_readEnd(AVLReader *reader);
+
+//----------------------------------------
+bool    AVLconcurrent_search(AVLConcurrent *tree, AVLReader *reader, const void *data, void *result);
+size_t  AVLconcurrent_range(AVLConcurrent *tree, AVLReader *reader, const void *low, const void *high,
+                            bool (*func)(void *, void *), void *extra_data);
+
+//----------------------------------------
+bool    AVLconcurrent_insert(AVLConcurrent *tree, const void *data);
+bool    AVLconcurrent_delete(AVLConcurrent *tree, const void *data);
+/*--------------------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,215 @@
+#include <string.h>
+
+#include "avlcopy.h"
+
+
+static void AVLcopy_retain(const AVLCopyOps *ops, AVLTree node) {
+    if (node && ops->retain)
+        ops->retain(node, ops->context);
+}
+
+static void AVLcopy_release(const AVLCopyOps *ops, AVLTree node) {
+    if (node && ops->release)
+        ops->release(node, ops->context);
+}
+
+/*
+ * Cree un nouveau noeud portant 'data' et prenant possession des references 'left' et
+ * 'right'. Les champs 'height' et 'count' sont calcules.
+ * Une version a moitie copiee ne pouvant pas etre rendue a l'appelant, un echec
+ * d'allocation interrompt le programme.
+ */
+static AVLTree AVLcopy_make(const AVLCopyOps *ops, const void *data, AVLTree left, AVLTree right) {
+    AVLTree node;
+
+    if (!(node = ops->alloc(ops->context)))
+        abort();
+    memcpy(node->data, data, ops->elemSize);
+    node->left = left;
+    node->right = right;
+    AVLtree_update(node);
+    return node;
+}
+
+//----------------------------------------
+/*
+ * Versions fonctionnelles des rotations : au lieu de modifier 'node' et son fils, on cree
+ * deux nouveaux noeuds et on abandonne les anciens. Le fils gauche (ou droit) remonte.
+ */
+static AVLTree AVLcopy_liftLeft(const AVLCopyOps *ops, AVLTree node) {
+    AVLTree child, lower;
+
+    child = node->left;
+    AVLcopy_retain(ops, child);
+    AVLcopy_retain(ops, node->right);
+    AVLcopy_retain(ops, child->left);
+    AVLcopy_retain(ops, child->right);
+
+    lower = AVLcopy_make(ops, node->data, child->right, node->right);
+    lower = AVLcopy_make(ops, child->data, child->left, lower);
+    AVLcopy_release(ops, node);
+    AVLcopy_release(ops, child);
+    return lower;
+}
+
+static AVLTree AVLcopy_liftRight(const AVLCopyOps *ops, AVLTree node) {
+    AVLTree child, lower;
+
+    child = node->right;
+    AVLcopy_retain(ops, child);
+    AVLcopy_retain(ops, node->left);
+    AVLcopy_retain(ops, child->left);
+    AVLcopy_retain(ops, child->right);
+
+    lower = AVLcopy_make(ops, node->data, node->left, child->left);
+    lower = AVLcopy_make(ops, child->data, lower, child->right);
+    AVLcopy_release(ops, node);
+    AVLcopy_release(ops, child);
+    return lower;
+}
+
+/*
+ * Reequilibre un noeud neuf, comme #AVLtree_rebalance() mais sans modifier les noeuds
+ * existants (qui peuvent etre partages avec d'autres versions).
+ */
+static AVLTree AVLcopy_balance(const AVLCopyOps *ops, AVLTree node) {
+    AVLTree child;
+    int     balance;
+
+    balance = (int) AVLtree_getHeight(node->left) - (int) AVLtree_getHeight(node->right);
+    if (balance > 1) {
+        if (AVLtree_getHeight(node->left->left) < AVLtree_getHeight(node->left->right)) {
+            AVLcopy_retain(ops, node->left);
+            AVLcopy_retain(ops, node->right);
+            child = AVLcopy_liftRight(ops, node->left);
+            child = AVLcopy_make(ops, node->data, child, node->right);
+            AVLcopy_release(ops, node);
+            node = child;
+        }
+        return AVLcopy_liftLeft(ops, node);
+    }
+    if (balance < -1) {
+        if (AVLtree_getHeight(node->right->right) < AVLtree_getHeight(node->right->left)) {
+            AVLcopy_retain(ops, node->left);
+            AVLcopy_retain(ops, node->right);
+            child = AVLcopy_liftLeft(ops, node->right);
+            child = AVLcopy_make(ops, node->data, node->left, child);
+            AVLcopy_release(ops, node);
+            node = child;
+        }
+        return AVLcopy_liftRight(ops, node);
+    }
+    return node;
+}
+
+//----------------------------------------
+/*
+ * Insertion fonctionnelle : la donnee est absente (verifie par l'appelant).
+ */
+static AVLTree AVLcopy_insertRec(const AVLCopyOps *ops, AVLTree node, const void *data) {
+    AVLTree left, right, copy;
+
+    if (!node)
+        return AVLcopy_make(ops, data, NULL, NULL);
+
+    left = node->left;
+    right = node->right;
+    AVLcopy_retain(ops, left);
+    AVLcopy_retain(ops, right);
+    if (ops->cmp3(data, node->data) < 0)
+        left = AVLcopy_insertRec(ops, left, data);
+    else
+        right = AVLcopy_insertRec(ops, right, data);
+
+    copy = AVLcopy_make(ops, node->data, left, right);
+    AVLcopy_release(ops, node);
+    return AVLcopy_balance(ops, copy);
+}
+
+/*
+ * Retire le minimum de 'node'. Le noeud minimum est rendu dans '*min' avec sa reference,
+ * pour que l'appelant puisse en recopier la donnee avant de l'abandonner.
+ */
+static AVLTree AVLcopy_deleteMin(const AVLCopyOps *ops, AVLTree node, AVLTree *min) {
+    AVLTree left, right, copy;
+
+    right = node->right;
+    AVLcopy_retain(ops, right);
+    if (!node->left) {
+        *min = node;
+        return right;
+    }
+
+    left = node->left;
+    AVLcopy_retain(ops, left);
+    left = AVLcopy_deleteMin(ops, left, min);
+    copy = AVLcopy_make(ops, node->data, left, right);
+    AVLcopy_release(ops, node);
+    return AVLcopy_balance(ops, copy);
+}
+
+/*
+ * Suppression fonctionnelle : la donnee est presente (verifie par l'appelant).
+ */
+static AVLTree AVLcopy_deleteRec(const AVLCopyOps *ops, AVLTree node, const void *data) {
+    AVLTree left, right, copy, min;
+    int     res;
+
+    left = node->left;
+    right = node->right;
+    AVLcopy_retain(ops, left);
+    AVLcopy_retain(ops, right);
+
+    if ((res = ops->cmp3(data, node->data)) < 0) {
+        left = AVLcopy_deleteRec(ops, left, data);
+    } else if (res > 0) {
+        right = AVLcopy_deleteRec(ops, right, data);
+    } else {
+        if (!left || !right) {
+            AVLcopy_release(ops, node);
+            return (left) ? left : right;
+        }
+        right = AVLcopy_deleteMin(ops, right, &min);
+        copy = AVLcopy_make(ops, min->data, left, right);
+        AVLcopy_release(ops, min);
+        AVLcopy_release(ops, node);
+        return AVLcopy_balance(ops, copy);
+    }
+
+    copy = AVLcopy_make(ops, node->data, left, right);
+    AVLcopy_release(ops, node);
+    return AVLcopy_balance(ops, copy);
+}
+
+//----------------------------------------
+/*
+ * Renvoie une nouvelle version de 'root' contenant 'data'. Si 'data' est deja present,
+ * rien n'est copie et 'root' est renvoye tel quel. '*inserted' (optionnel) indique si
+ * l'insertion a eu lieu.
+ */
+AVLTree AVLcopy_insert(const AVLCopyOps *ops, AVLTree root, const void *data, bool *inserted) {
+    bool found;
+
+    found = AVLtree_search3(root, ops->cmp3, data) != NULL;
+    if (inserted)
+        *inserted = !found;
+    if (found)
+        return root;
+    return AVLcopy_insertRec(ops, root, data);
+}
+
+/*
+ * Renvoie une nouvelle version de 'root' sans 'data'. Si 'data' est absent, rien n'est
+ * copie et 'root' est renvoye tel quel. '*deleted' (optionnel) indique si la suppression
+ * a eu lieu.
+ */
+AVLTree AVLcopy_delete(const AVLCopyOps *ops, AVLTree root, const void *data, bool *deleted) {
+    bool found;
+
+    found = AVLtree_search3(root, ops->cmp3, data) != NULL;
+    if (deleted)
+        *deleted = found;
+    if (!found)
+        return root;
+    return AVLcopy_deleteRec(ops, root, data);
+}
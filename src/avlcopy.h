@@ -0,0 +1,36 @@
+#ifndef _AVLCOPY_H_
+#define _AVLCOPY_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "avltree.h"
+
+
+/*
+ * Moteur d'ecriture par copie de chemin : une insertion ou une suppression ne modifie aucun
+ * noeud existant, elle recopie les O(log n) noeuds du chemin et renvoie une nouvelle racine
+ * qui partage tout le reste avec l'ancienne.
+ * Le devenir des noeuds remplaces est delegue a l'appelant par trois fonctions :
+ *  - 'alloc' fournit un noeud de AVLtree_nodeSize(elemSize) octets ;
+ *  - 'retain' signale qu'une reference de plus est prise sur un noeud ;
+ *  - 'release' abandonne une reference (le noeud n'est plus utilise par la nouvelle version).
+ * Toutes les fonctions prennent possession de la reference sur 'root' passee en parametre
+ * et rendent une reference sur la racine renvoyee.
+ */
+typedef struct AVLCopyOps AVLCopyOps;
+struct          AVLCopyOps {
+        int     (*cmp3)(const void *, const void *);
+        size_t  elemSize;
+        AVLTree (*alloc)(void *context);
+        void    (*retain)(AVLTree node, void *context);
+        void    (*release)(AVLTree node, void *context);
+        void    *context;
+};
+
+/*--------------------------------------------------------------------*/
+AVLTree AVLcopy_insert(const AVLCopyOps *ops, AVLTree root, const void *data, bool *inserted);
+AVLTree AVLcopy_delete(const AVLCopyOps *ops, AVLTree root, const void *data, bool *deleted);
+/*--------------------------------------------------------------------*/
+
+#endif
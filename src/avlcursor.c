@@ -0,0 +1,199 @@
+#include "avlcursor.h"
+
+
+/*
+ * Place le curseur sur l'arbre 'tree', sans position courante.
+ * Utiliser ensuite #AVLcursor_first(), #AVLcursor_seek(), #AVLcursor_lowerBound()...
+ */
+void    AVLcursor_init(AVLCursor *cursor, const AVLTree tree) {
+    cursor->root = tree;
+    cursor->depth = 0;
+}
+
+/*
+ * Indique si le curseur est positionne sur un noeud.
+ */
+bool    AVLcursor_valid(const AVLCursor *cursor) {
+    return cursor->depth > 0;
+}
+
+/*
+ * Renvoie le noeud courant, ou NULL si le curseur n'est pas positionne.
+ */
+AVLTree AVLcursor_getNode(const AVLCursor *cursor) {
+    if (cursor->depth > 0)
+        return cursor->stack[cursor->depth - 1];
+    return NULL;
+}
+
+/*
+ * Renvoie la donnee du noeud courant, ou NULL si le curseur n'est pas positionne.
+ */
+void    *AVLcursor_getData(const AVLCursor *cursor) {
+    return AVLtree_getData(AVLcursor_getNode(cursor));
+}
+
+//----------------------------------------
+/*
+ * Empile 'node' puis toute la branche gauche (ou droite) qui en part.
+ */
+static void AVLcursor_pushLeft(AVLCursor *cursor, AVLTree node) {
+    while (node) {
+        cursor->stack[cursor->depth++] = node;
+        node = node->left;
+    }
+}
+
+static void AVLcursor_pushRight(AVLCursor *cursor, AVLTree node) {
+    while (node) {
+        cursor->stack[cursor->depth++] = node;
+        node = node->right;
+    }
+}
+
+/*
+ * Positionne le curseur sur le plus petit element. Renvoie false si l'arbre est vide.
+ */
+bool    AVLcursor_first(AVLCursor *cursor) {
+    cursor->depth = 0;
+    AVLcursor_pushLeft(cursor, cursor->root);
+    return cursor->depth > 0;
+}
+
+/*
+ * Positionne le curseur sur le plus grand element. Renvoie false si l'arbre est vide.
+ */
+bool    AVLcursor_last(AVLCursor *cursor) {
+    cursor->depth = 0;
+    AVLcursor_pushRight(cursor, cursor->root);
+    return cursor->depth > 0;
+}
+
+/*
+ * Descente commune a seek/lowerBound/upperBound.
+ * On enregistre le chemin et on retient la profondeur du dernier noeud candidat : celui-ci
+ * etant un ancetre des noeuds visites ensuite, il suffit de tronquer la pile a la fin.
+ * 'strict' distingue la borne superieure (premier element > data) de la borne inferieure
+ * (premier element >= data).
+ */
+static bool AVLcursor_bound(AVLCursor *cursor, int (*cmp3)(const void *, const void *), const void *data, bool strict) {
+    AVLTree node;
+    int     found, res;
+
+    cursor->depth = 0;
+    found = 0;
+    node = cursor->root;
+    while (node) {
+        cursor->stack[cursor->depth++] = node;
+        res = cmp3(data, node->data);
+        if (res < 0 || (res == 0 && !strict)) {
+            found = cursor->depth;
+            if (res == 0)
+                break;
+            node = node->left;
+        } else {
+            node = node->right;
+        }
+    }
+    cursor->depth = found;
+    return found > 0;
+}
+
+/*
+ * Positionne le curseur sur l'element egal a 'data'. Renvoie false (et invalide le curseur)
+ * si 'data' n'est pas dans l'arbre.
+ */
+bool    AVLcursor_seek(AVLCursor *cursor, int (*cmp3)(const void *, const void *), const void *data) {
+    if (AVLcursor_bound(cursor, cmp3, data, false) && cmp3(data, AVLcursor_getData(cursor)) == 0)
+        return true;
+    cursor->depth = 0;
+    return false;
+}
+
+/*
+ * Positionne le curseur sur le premier element superieur ou egal a 'data'.
+ */
+bool    AVLcursor_lowerBound(AVLCursor *cursor, int (*cmp3)(const void *, const void *), const void *data) {
+    return AVLcursor_bound(cursor, cmp3, data, false);
+}
+
+/*
+ * Positionne le curseur sur le premier element strictement superieur a 'data'.
+ */
+bool    AVLcursor_upperBound(AVLCursor *cursor, int (*cmp3)(const void *, const void *), const void *data) {
+    return AVLcursor_bound(cursor, cmp3, data, true);
+}
+
+//----------------------------------------
+/*
+ * Avance le curseur sur l'element suivant dans l'ordre.
+ * S'il y a un fils droit, le suivant est le minimum de ce sous-arbre ; sinon on remonte
+ * tant qu'on vient d'un fils droit. Renvoie false a la fin de l'arbre.
+ */
+bool    AVLcursor_next(AVLCursor *cursor) {
+    AVLTree node;
+
+    if (cursor->depth == 0)
+        return false;
+
+    node = cursor->stack[cursor->depth - 1];
+    if (node->right) {
+        AVLcursor_pushLeft(cursor, node->right);
+        return true;
+    }
+
+    do {
+        node = cursor->stack[--cursor->depth];
+    } while (cursor->depth > 0 && cursor->stack[cursor->depth - 1]->right == node);
+    return cursor->depth > 0;
+}
+
+/*
+ * Recule le curseur sur l'element precedent dans l'ordre (symetrique de #AVLcursor_next()).
+ */
+bool    AVLcursor_prev(AVLCursor *cursor) {
+    AVLTree node;
+
+    if (cursor->depth == 0)
+        return false;
+
+    node = cursor->stack[cursor->depth - 1];
+    if (node->left) {
+        AVLcursor_pushRight(cursor, node->left);
+        return true;
+    }
+
+    do {
+        node = cursor->stack[--cursor->depth];
+    } while (cursor->depth > 0 && cursor->stack[cursor->depth - 1]->left == node);
+    return cursor->depth > 0;
+}
+
+//----------------------------------------
+/*
+ * Parcours de l'intervalle [low, high) : applique 'func' a chaque donnee de l'intervalle,
+ * dans l'ordre, tant que 'func' renvoie true. 'low' ou 'high' a NULL rend l'intervalle
+ * ouvert de ce cote.
+ * Le cout est celui d'une descente plus le nombre d'elements visites, au lieu d'un
+ * parcours complet de l'arbre. Renvoie le nombre d'elements passes a 'func'.
+ */
+size_t  AVLtree_range(const AVLTree tree, int (*cmp3)(const void *, const void *), const void *low, const void *high,
+                      bool (*func)(void *, void *), void *extra_data) {
+    AVLCursor   cursor;
+    size_t      nbVisited;
+    bool        valid;
+
+    AVLcursor_init(&cursor, tree);
+    valid = (low) ? AVLcursor_lowerBound(&cursor, cmp3, low) : AVLcursor_first(&cursor);
+
+    nbVisited = 0;
+    while (valid) {
+        if (high && cmp3(AVLcursor_getData(&cursor), high) >= 0)
+            break;
+        nbVisited++;
+        if (!func(AVLcursor_getData(&cursor), extra_data))
+            break;
+        valid = AVLcursor_next(&cursor);
+    }
+    return nbVisited;
+}
@@ -0,0 +1,44 @@
+#ifndef _AVLCURSOR_H_
+#define _AVLCURSOR_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "avltree.h"
+
+
+/*
+ * Curseur ordonne sur un arbre : garde le chemin de la racine jusqu'au noeud courant,
+ * ce qui permet d'avancer, de reculer ou de s'arreter a tout moment sans recursion.
+ * Toute modification de l'arbre invalide les curseurs ouverts dessus.
+ */
+typedef struct AVLCursor AVLCursor;
+struct          AVLCursor {
+        AVLTree root;
+        AVLTree stack[AVLTREE_MAX_HEIGHT];
+        int     depth;
+};
+
+/*--------------------------------------------------------------------*/
+void    AVLcursor_init(AVLCursor *cursor, const AVLTree tree);
+bool    AVLcursor_valid(const AVLCursor *cursor);
+AVLTree AVLcursor_getNode(const AVLCursor *cursor);
+void    *AVLcursor_getData(const AVLCursor *cursor);
+
+//----------------------------------------
+bool    AVLcursor_first(AVLCursor *cursor);
+bool    AVLcursor_last(AVLCursor *cursor);
+bool    AVLcursor_seek(AVLCursor *cursor, int (*cmp3)(const void *, const void *), const void *data);
+bool    AVLcursor_lowerBound(AVLCursor *cursor, int (*cmp3)(const void *, const void *), const void *data);
+bool    AVLcursor_upperBound(AVLCursor *cursor, int (*cmp3)(const void *, const void *), const void *data);
+
+//----------------------------------------
+bool    AVLcursor_next(AVLCursor *cursor);
+bool    AVLcursor_prev(AVLCursor *cursor);
+
+//----------------------------------------
+size_t  AVLtree_range(const AVLTree tree, int (*cmp3)(const void *, const void *), const void *low, const void *high,
+                      bool (*func)(void *, void *), void *extra_data);
+/*--------------------------------------------------------------------*/
+
+#endif
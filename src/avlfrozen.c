@@ -0,0 +1,264 @@
+#include <string.h>
+#include <limits.h>
+
+#include "avlfrozen.h"
+#include "avlcursor.h"
+#include "min-max.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define AVLFROZEN_X86   1
+#else
+#define AVLFROZEN_X86   0
+#endif
+
+
+#define AVLFROZEN_LINE  64
+
+/*
+ * Parcours infixe des cases 1..size d'un tableau d'Eytzinger, sans pile : la premiere
+ * case est au bout de la branche gauche ; apres k on descend a gauche depuis le fils droit
+ * s'il existe, sinon on remonte tant que k est un fils droit puis encore d'un niveau.
+ * Cette remontee revient a supprimer les bits de poids faible a 1 et le 0 qui les suit.
+ */
+static size_t AVLfrozen_first(size_t size) {
+    size_t k = 1;
+
+    while (2 * k <= size)
+        k *= 2;
+    return k;
+}
+
+static size_t AVLfrozen_next(size_t k, size_t size) {
+    if (2 * k + 1 <= size) {
+        k = 2 * k + 1;
+        while (2 * k <= size)
+            k *= 2;
+        return k;
+    }
+    return k >> __builtin_ffsll((long long) ~k);
+}
+
+/*
+ * Exporte 'tree' dans 'frozen'. 'keySize' octets en tete de chaque donnee de 'elemSize'
+ * octets servent de cle, et 'cmp3' ne doit lire que ces octets : il est appele avec la
+ * cle cherchee et une cle du tableau.
+ * L'arbre n'est pas modifie et peut etre libere ensuite. Renvoie false si l'allocation
+ * echoue ou si les tailles sont incoherentes.
+ */
+bool    AVLtree_freeze(const AVLTree tree, AVLFrozen *frozen, size_t elemSize, size_t keySize,
+                       int (*cmp3)(const void *, const void *)) {
+    AVLCursor   cursor;
+    size_t      size;
+    size_t      bytes;
+    size_t      k;
+
+    if (!frozen || !keySize || keySize > elemSize)
+        return false;
+
+    size = AVLtree_getSize(tree);
+    bytes = ((size + 1) * keySize + AVLFROZEN_LINE - 1) / AVLFROZEN_LINE * AVLFROZEN_LINE;
+    frozen->keys = (char *) aligned_alloc(AVLFROZEN_LINE, bytes);
+    frozen->payloads = (char *) malloc(size ? size * elemSize : 1);
+    if (!frozen->keys || !frozen->payloads) {
+        free(frozen->keys);
+        free(frozen->payloads);
+        return false;
+    }
+    memset(frozen->keys, 0, bytes);
+
+    frozen->size = size;
+    frozen->keySize = keySize;
+    frozen->elemSize = elemSize;
+    frozen->cmp3 = cmp3;
+    frozen->levels = 0;
+    for (k = size; k; k >>= 1)
+        frozen->levels++;
+
+    AVLcursor_init(&cursor, tree);
+    k = AVLfrozen_first(size);
+    for (AVLcursor_first(&cursor); AVLcursor_valid(&cursor); AVLcursor_next(&cursor)) {
+        memcpy(frozen->keys + k * keySize, AVLcursor_getData(&cursor), keySize);
+        memcpy(frozen->payloads + (k - 1) * elemSize, AVLcursor_getData(&cursor), elemSize);
+        k = AVLfrozen_next(k, size);
+    }
+    return true;
+}
+
+/*
+ * Libere les tableaux d'une copie figee.
+ */
+void    AVLfrozen_destroy(AVLFrozen *frozen) {
+    if (!frozen)
+        return;
+    free(frozen->keys);
+    free(frozen->payloads);
+    frozen->keys = NULL;
+    frozen->payloads = NULL;
+    frozen->size = 0;
+    frozen->levels = 0;
+}
+
+/*
+ * Renvoie le nombre d'elements de la copie figee.
+ */
+size_t  AVLfrozen_getSize(const AVLFrozen *frozen) {
+    if (frozen)
+        return frozen->size;
+    return 0;
+}
+
+//----------------------------------------
+/*
+ * Descente sans branchement dependant des cles : a chaque niveau k devient 2k ou 2k+1
+ * selon le resultat de la comparaison, qui n'est utilise que comme entier. On precharge
+ * les descendants 4 niveaux plus bas (16 cases contigues a partir de 16k).
+ * A la sortie, les bits de k decrivent le chemin suivi ; le dernier virage a gauche
+ * designe le premier element >= key. Renvoie sa case, ou 0 s'il n'y en a pas.
+ */
+static size_t AVLfrozen_descend(const AVLFrozen *frozen, const void *key) {
+    size_t k = 1;
+
+    while (k <= frozen->size) {
+        __builtin_prefetch(frozen->keys + MIN(16 * k, frozen->size) * frozen->keySize);
+        k = 2 * k + (frozen->cmp3(key, frozen->keys + k * frozen->keySize) > 0);
+    }
+    return k >> __builtin_ffsll((long long) ~k);
+}
+
+/*
+ * Renvoie la donnee dont la cle est egale a 'key', ou NULL.
+ */
+void    *AVLfrozen_search(const AVLFrozen *frozen, const void *key) {
+    size_t k = AVLfrozen_descend(frozen, key);
+
+    if (k && !frozen->cmp3(key, frozen->keys + k * frozen->keySize))
+        return frozen->payloads + (k - 1) * frozen->elemSize;
+    return NULL;
+}
+
+/*
+ * Renvoie la premiere donnee dont la cle est >= 'key', ou NULL.
+ */
+void    *AVLfrozen_lowerBound(const AVLFrozen *frozen, const void *key) {
+    size_t k = AVLfrozen_descend(frozen, key);
+
+    if (k)
+        return frozen->payloads + (k - 1) * frozen->elemSize;
+    return NULL;
+}
+
+//----------------------------------------
+/*
+ * Cas des cles entieres : la cle est un 'int' en tete de la donnee et l'ordre de 'cmp3'
+ * est celui des entiers signes. La comparaison est faite en ligne, sans appel indirect.
+ */
+static inline size_t AVLfrozen_descendInt(const AVLFrozen *frozen, int key) {
+    const int   *keys = (const int *) frozen->keys;
+    size_t      k = 1;
+
+    while (k <= frozen->size) {
+        __builtin_prefetch(keys + MIN(16 * k, frozen->size));
+        k = 2 * k + (key > keys[k]);
+    }
+    return k >> __builtin_ffsll((long long) ~k);
+}
+
+static inline void *AVLfrozen_resultInt(const AVLFrozen *frozen, size_t k, int key) {
+    if (k && ((const int *) frozen->keys)[k] == key)
+        return frozen->payloads + (k - 1) * frozen->elemSize;
+    return NULL;
+}
+
+/*
+ * Renvoie la donnee de cle entiere 'key', ou NULL. La copie doit avoir ete figee avec
+ * keySize == sizeof(int).
+ */
+void    *AVLfrozen_searchInt(const AVLFrozen *frozen, int key) {
+    return AVLfrozen_resultInt(frozen, AVLfrozen_descendInt(frozen, key), key);
+}
+
+#if AVLFROZEN_X86
+/*
+ * Noyaux SIMD : plusieurs recherches descendent en meme temps, une par voie. Une voie
+ * arrivee sous les feuilles (k > size) est figee et lit la case 0 jusqu'a la fin ; toutes
+ * les voies font donc 'levels' tours sans branchement. La fin (dernier virage a gauche,
+ * egalite) est faite voie par voie comme dans la version scalaire.
+ * AVX2 lit les cles avec un 'gather' sur 8 voies ; SSE2, qui n'en a pas, les charge une
+ * a une sur 4 voies et ne vectorise que la comparaison et la mise a jour de k.
+ */
+__attribute__((target("avx2")))
+static size_t AVLfrozen_batchAVX2(const AVLFrozen *frozen, const int *keys, size_t count, void **results) {
+    const int   *table = (const int *) frozen->keys;
+    __m256i     one = _mm256_set1_epi32(1);
+    __m256i     limit = _mm256_set1_epi32((int) frozen->size + 1);
+    __m256i     query, k, active, value, next;
+    int         lanes[8];
+    size_t      i;
+    int         level, lane;
+
+    for (i = 0; i + 8 <= count; i += 8) {
+        query = _mm256_loadu_si256((const __m256i *) (keys + i));
+        k = one;
+        for (level = 0; level < frozen->levels; level++) {
+            active = _mm256_cmpgt_epi32(limit, k);
+            value = _mm256_i32gather_epi32(table, _mm256_and_si256(k, active), sizeof(int));
+            next = _mm256_sub_epi32(_mm256_add_epi32(k, k), _mm256_cmpgt_epi32(query, value));
+            k = _mm256_blendv_epi8(k, next, active);
+        }
+        _mm256_storeu_si256((__m256i *) lanes, k);
+        for (lane = 0; lane < 8; lane++)
+            results[i + lane] = AVLfrozen_resultInt(frozen, (size_t) lanes[lane] >> __builtin_ffs(~lanes[lane]),
+                                                    keys[i + lane]);
+    }
+    return i;
+}
+
+__attribute__((target("sse2")))
+static size_t AVLfrozen_batchSSE2(const AVLFrozen *frozen, const int *keys, size_t count, void **results) {
+    const int   *table = (const int *) frozen->keys;
+    __m128i     one = _mm_set1_epi32(1);
+    __m128i     limit = _mm_set1_epi32((int) frozen->size + 1);
+    __m128i     query, k, active, value, next;
+    int         lanes[4];
+    size_t      i;
+    int         level, lane;
+
+    for (i = 0; i + 4 <= count; i += 4) {
+        query = _mm_loadu_si128((const __m128i *) (keys + i));
+        k = one;
+        for (level = 0; level < frozen->levels; level++) {
+            active = _mm_cmpgt_epi32(limit, k);
+            _mm_storeu_si128((__m128i *) lanes, _mm_and_si128(k, active));
+            value = _mm_set_epi32(table[lanes[3]], table[lanes[2]], table[lanes[1]], table[lanes[0]]);
+            next = _mm_sub_epi32(_mm_add_epi32(k, k), _mm_cmpgt_epi32(query, value));
+            k = _mm_or_si128(_mm_and_si128(active, next), _mm_andnot_si128(active, k));
+        }
+        _mm_storeu_si128((__m128i *) lanes, k);
+        for (lane = 0; lane < 4; lane++)
+            results[i + lane] = AVLfrozen_resultInt(frozen, (size_t) lanes[lane] >> __builtin_ffs(~lanes[lane]),
+                                                    keys[i + lane]);
+    }
+    return i;
+}
+#endif
+
+/*
+ * Recherche 'count' cles entieres d'un coup ; results[i] recoit la donnee de keys[i] ou
+ * NULL. Le noyau SIMD est choisi a l'execution selon le processeur ; les cles restantes,
+ * ou toutes si les indices ne tiennent pas sur 31 bits, passent par la version scalaire.
+ */
+void    AVLfrozen_searchIntBatch(const AVLFrozen *frozen, const int *keys, size_t count, void **results) {
+    size_t i = 0;
+
+#if AVLFROZEN_X86
+    if (frozen->size < INT_MAX / 2) {
+        if (__builtin_cpu_supports("avx2"))
+            i = AVLfrozen_batchAVX2(frozen, keys, count, results);
+        else if (__builtin_cpu_supports("sse2"))
+            i = AVLfrozen_batchSSE2(frozen, keys, count, results);
+    }
+#endif
+    for (; i < count; i++)
+        results[i] = AVLfrozen_searchInt(frozen, keys[i]);
+}
@@ -0,0 +1,46 @@
+#ifndef _AVLFROZEN_H_
+#define _AVLFROZEN_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "avltree.h"
+
+
+/*
+ * Copie figee d'un arbre, en lecture seule, rangee dans un tableau contigu selon l'ordre
+ * d'Eytzinger (ordre d'un tas : les fils de la case k sont les cases 2k et 2k+1, la case 0
+ * est inutilisee).
+ * Les cles (les 'keySize' premiers octets de chaque donnee) sont separees des donnees
+ * completes : une recherche ne parcourt que le tableau des cles, aligne sur une ligne de
+ * cache, et les 16 descendants de la case k situes 4 niveaux plus bas sont contigus, ce
+ * qui permet de les precharger.
+ * La donnee de la case k se trouve a 'payloads + (k - 1) * elemSize'.
+ */
+typedef struct AVLFrozen AVLFrozen;
+struct          AVLFrozen {
+        size_t  size;
+        size_t  keySize;
+        size_t  elemSize;
+        int     levels;
+        char    *keys;
+        char    *payloads;
+        int     (*cmp3)(const void *, const void *);
+};
+
+/*--------------------------------------------------------------------*/
+bool    AVLtree_freeze(const AVLTree tree, AVLFrozen *frozen, size_t elemSize, size_t keySize,
+                       int (*cmp3)(const void *, const void *));
+void    AVLfrozen_destroy(AVLFrozen *frozen);
+size_t  AVLfrozen_getSize(const AVLFrozen *frozen);
+
+//----------------------------------------
+void    *AVLfrozen_search(const AVLFrozen *frozen, const void *key);
+void    *AVLfrozen_lowerBound(const AVLFrozen *frozen, const void *key);
+
+//----------------------------------------
+void    *AVLfrozen_searchInt(const AVLFrozen *frozen, int key);
+void    AVLfrozen_searchIntBatch(const AVLFrozen *frozen, const int *keys, size_t count, void **results);
+/*--------------------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,209 @@
+#include <string.h>
+
+#include "avlhandle.h"
+
+
+/*
+ * Initialise une poignee sur un arbre vide de donnees de 'elemSize' octets comparees avec
+ * 'cmp3'. Les noeuds sont pris dans 'pool' s'il est non nul.
+ */
+bool    AVLhandle_init(AVLHandle *handle, size_t elemSize, int (*cmp3)(const void *, const void *), AVLPool *pool) {
+    if (!handle || !cmp3)
+        return false;
+
+    handle->root = NULL;
+    handle->ops = (AVLOps) { .cmp3 = cmp3, .pool = pool };
+    handle->elemSize = elemSize;
+    handle->count = 0;
+    handle->min = NULL;
+    handle->max = NULL;
+    handle->fingerDepth = 0;
+    return true;
+}
+
+/*
+ * Libere tous les noeuds ; la poignee reste utilisable.
+ */
+void    AVLhandle_destroy(AVLHandle *handle) {
+    AVLtree_deleteTreeOps(&handle->root, &handle->ops);
+    handle->count = 0;
+    handle->min = NULL;
+    handle->max = NULL;
+    handle->fingerDepth = 0;
+}
+
+/*
+ * Renvoie le nombre d'elements, en temps constant.
+ */
+size_t  AVLhandle_getSize(const AVLHandle *handle) {
+    return handle->count;
+}
+
+//----------------------------------------
+/*
+ * Renvoie le noeud egal a 'data', ou NULL.
+ */
+AVLTree AVLhandle_search(const AVLHandle *handle, const void *data) {
+    return AVLtree_searchOps(handle->root, &handle->ops, data);
+}
+
+/*
+ * Accroche un nouveau noeud pour 'data' au bout de 'path'. Le nouveau noeud est le minimum
+ * s'il devient le fils gauche du minimum, le maximum s'il devient le fils droit du maximum :
+ * aucune comparaison de plus n'est necessaire.
+ * Si 'keepFinger' est vrai, le chemin jusqu'au nouveau noeud devient le doigt. Au plus une
+ * rotation (simple ou double) a lieu : les niveaux au-dessus gardent leur noeud, et le
+ * doigt n'est a reprendre, par comparaisons, qu'a partir du niveau tourne. Sinon le doigt
+ * est efface.
+ */
+static bool AVLhandle_insertPath(AVLHandle *handle, AVLPath *path, const void *data, bool keepFinger) {
+    AVLTree node, parent, current;
+    int     level;
+
+    if (!(node = AVLtree_allocNode(&handle->ops, handle->elemSize)))
+        return false;
+    memcpy(node->data, data, handle->elemSize);
+
+    parent = (path->depth > 1) ? *path->link[path->depth - 2] : NULL;
+    if (!parent || (parent == handle->min && path->link[path->depth - 1] == &parent->left))
+        handle->min = node;
+    if (!parent || (parent == handle->max && path->link[path->depth - 1] == &parent->right))
+        handle->max = node;
+
+    handle->fingerDepth = 0;
+    if (keepFinger)
+        for (level = 0; level < path->depth - 1; level++)
+            handle->finger[level] = *path->link[level];
+
+    AVLtree_pathInsert(path, &handle->ops, node);
+    handle->count++;
+    if (!keepFinger)
+        return true;
+
+    for (level = 0; level < path->depth - 1 && *path->link[level] == handle->finger[level]; level++)
+        ;
+    for (current = *path->link[level]; current != node; level++) {
+        handle->finger[level] = current;
+        current = (AVLtree_compare(&handle->ops, data, current->data) < 0) ? current->left : current->right;
+    }
+    handle->finger[level] = node;
+    handle->fingerDepth = level + 1;
+    return true;
+}
+
+/*
+ * Insere une copie de 'data' apres une descente depuis la racine (le doigt est efface).
+ * Renvoie false si la donnee est deja presente ou si la memoire manque.
+ */
+bool    AVLhandle_insert(AVLHandle *handle, const void *data) {
+    AVLPath path;
+
+    if (AVLtree_pathFind(&handle->root, &handle->ops, data, &path))
+        return false;
+    return AVLhandle_insertPath(handle, &path, data, false);
+}
+
+/*
+ * Insere une copie de 'data' en cherchant sa place a partir de 'hint', un curseur ouvert
+ * sur l'arbre de la poignee depuis sa derniere modification, ou a partir du doigt de la
+ * derniere insertion si 'hint' est nul. Un curseur qui ne part pas de la racine actuelle
+ * est ignore. Pour une donnee voisine du point de depart, la place est trouvee en un
+ * nombre constant de comparaisons en moyenne ; sinon le cout reste logarithmique.
+ * Renvoie false si la donnee est deja presente ou si la memoire manque.
+ */
+bool    AVLhandle_insertHint(AVLHandle *handle, const AVLCursor *hint, const void *data) {
+    AVLPath path;
+    AVLTree found;
+
+    if (hint)
+        found = AVLtree_pathFindHint(&handle->root, &handle->ops, hint->stack, hint->depth, data, &path);
+    else
+        found = AVLtree_pathFindHint(&handle->root, &handle->ops, handle->finger, handle->fingerDepth, data, &path);
+    if (found)
+        return false;
+    return AVLhandle_insertPath(handle, &path, data, true);
+}
+
+/*
+ * Decroche et libere le noeud qui termine 'path', en copiant d'abord sa donnee dans 'data'
+ * (optionnel). Le minimum n'a pas de fils gauche : son successeur est son fils droit s'il
+ * existe, sinon son pere, et les rotations de la remontee ne deplacent aucune donnee.
+ */
+static void AVLhandle_remove(AVLHandle *handle, AVLPath *path, void *data) {
+    AVLTree node, parent;
+
+    node = *path->link[path->depth - 1];
+    parent = (path->depth > 1) ? *path->link[path->depth - 2] : NULL;
+    if (node == handle->min)
+        handle->min = (node->right) ? node->right : parent;
+    if (node == handle->max)
+        handle->max = (node->left) ? node->left : parent;
+
+    if (data)
+        memcpy(data, node->data, handle->elemSize);
+    AVLtree_freeNode(&handle->ops, AVLtree_pathRemove(path, &handle->ops));
+    handle->count--;
+    handle->fingerDepth = 0;
+}
+
+/*
+ * Supprime l'element egal a 'data'. Renvoie false s'il est absent.
+ */
+bool    AVLhandle_delete(AVLHandle *handle, const void *data) {
+    AVLPath path;
+
+    if (!AVLtree_pathFind(&handle->root, &handle->ops, data, &path))
+        return false;
+    AVLhandle_remove(handle, &path, NULL);
+    return true;
+}
+
+//----------------------------------------
+/*
+ * Renvoie la plus petite (plus grande) donnee en temps constant, ou NULL si l'arbre est vide.
+ */
+void    *AVLhandle_peekMin(const AVLHandle *handle) {
+    return AVLtree_getData(handle->min);
+}
+
+void    *AVLhandle_peekMax(const AVLHandle *handle) {
+    return AVLtree_getData(handle->max);
+}
+
+/*
+ * Chemin de la racine jusqu'au bout de la branche gauche (ou droite), sans comparaison.
+ */
+static void AVLhandle_spine(AVLHandle *handle, AVLPath *path, bool left) {
+    AVLTree *link;
+
+    path->depth = 0;
+    link = &handle->root;
+    while (*link) {
+        path->link[path->depth++] = link;
+        link = (left) ? &(*link)->left : &(*link)->right;
+    }
+}
+
+/*
+ * Retire le plus petit (plus grand) element et copie sa donnee dans 'data' (optionnel).
+ * Renvoie false si l'arbre est vide.
+ */
+bool    AVLhandle_popMin(AVLHandle *handle, void *data) {
+    AVLPath path;
+
+    if (!handle->root)
+        return false;
+    AVLhandle_spine(handle, &path, true);
+    AVLhandle_remove(handle, &path, data);
+    return true;
+}
+
+bool    AVLhandle_popMax(AVLHandle *handle, void *data) {
+    AVLPath path;
+
+    if (!handle->root)
+        return false;
+    AVLhandle_spine(handle, &path, false);
+    AVLhandle_remove(handle, &path, data);
+    return true;
+}
@@ -0,0 +1,57 @@
+#ifndef _AVLHANDLE_H_
+#define _AVLHANDLE_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "avltree.h"
+#include "avlcursor.h"
+
+
+/*
+ * Poignee sur un arbre : la racine, les parametres du moteur, le nombre d'elements et les
+ * noeuds minimum et maximum, tenus a jour a chaque modification.
+ * Le minimum et le maximum se lisent en temps constant. Un noeud etant decroche sans que
+ * sa donnee soit deplacee, le nouveau minimum apres un retrait est le fils droit de
+ * l'ancien ou, a defaut, son pere : #AVLhandle_popMin() descend donc la branche gauche
+ * sans aucune comparaison et reequilibre en remontant, arrete des que la hauteur ne
+ * change plus (de meme pour le maximum).
+ * La poignee garde aussi un doigt, le chemin de la racine jusqu'au dernier noeud insere :
+ * #AVLhandle_insertHint() part de ce chemin (ou de la position d'un curseur) et ne compare
+ * la donnee qu'a quelques noeuds quand elle tombe a cote, ce qui rend quasi gratuite la
+ * recherche de la place d'insertion pour des donnees croissantes ou presque triees.
+ * Le doigt est recalcule apres une rotation, a partir du noeud tourne ; une insertion
+ * ordinaire ou une suppression l'efface.
+ * L'arbre ne doit etre modifie que par les fonctions AVLhandle_*.
+ */
+typedef struct AVLHandle AVLHandle;
+struct          AVLHandle {
+        AVLTree root;
+        AVLOps  ops;
+        size_t  elemSize;
+        size_t  count;
+        AVLTree min;
+        AVLTree max;
+        AVLTree finger[AVLTREE_MAX_HEIGHT];
+        int     fingerDepth;
+};
+
+/*--------------------------------------------------------------------*/
+bool    AVLhandle_init(AVLHandle *handle, size_t elemSize, int (*cmp3)(const void *, const void *), AVLPool *pool);
+void    AVLhandle_destroy(AVLHandle *handle);
+size_t  AVLhandle_getSize(const AVLHandle *handle);
+
+//----------------------------------------
+AVLTree AVLhandle_search(const AVLHandle *handle, const void *data);
+bool    AVLhandle_insert(AVLHandle *handle, const void *data);
+bool    AVLhandle_insertHint(AVLHandle *handle, const AVLCursor *hint, const void *data);
+bool    AVLhandle_delete(AVLHandle *handle, const void *data);
+
+//----------------------------------------
+void    *AVLhandle_peekMin(const AVLHandle *handle);
+void    *AVLhandle_peekMax(const AVLHandle *handle);
+bool    AVLhandle_popMin(AVLHandle *handle, void *data);
+bool    AVLhandle_popMax(AVLHandle *handle, void *data);
+/*--------------------------------------------------------------------*/
+
+#endif
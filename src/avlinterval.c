@@ -0,0 +1,175 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "avlinterval.h"
+
+
+/*
+ * Requete en cours : intervalle cherche, fonction de l'appelant et nombre d'intervalles
+ * qui lui ont ete passes.
+ */
+typedef struct {
+    int64_t     low;
+    int64_t     high;
+    bool        (*func)(const AVLInterval *, void *);
+    void        *extra_data;
+    size_t      nbVisited;
+} AVLIntervalQuery;
+
+//----------------------------------------
+/*
+ * Les champs sont lus et ecrits par memcpy : la donnee d'un noeud n'est pas forcement
+ * alignee sur 8 octets.
+ */
+static int64_t AVLinterval_maxHigh(const AVLTree node) {
+    int64_t maxHigh;
+
+    memcpy(&maxHigh, node->data + offsetof(AVLInterval, maxHigh), sizeof(maxHigh));
+    return maxHigh;
+}
+
+/*
+ * Augmentation : 'maxHigh' du noeud d'apres sa borne haute et le 'maxHigh' de ses fils.
+ */
+static void AVLinterval_augment(AVLTree node) {
+    int64_t maxHigh;
+
+    memcpy(&maxHigh, node->data + offsetof(AVLInterval, high), sizeof(maxHigh));
+    if (node->left && AVLinterval_maxHigh(node->left) > maxHigh)
+        maxHigh = AVLinterval_maxHigh(node->left);
+    if (node->right && AVLinterval_maxHigh(node->right) > maxHigh)
+        maxHigh = AVLinterval_maxHigh(node->right);
+    memcpy(node->data + offsetof(AVLInterval, maxHigh), &maxHigh, sizeof(maxHigh));
+}
+
+/*
+ * Ordre des intervalles : par debut, puis par fin, puis par adresse de la valeur.
+ */
+static int AVLinterval_compare3(const void *a, const void *b) {
+    AVLInterval x, y;
+
+    memcpy(&x, a, sizeof(x));
+    memcpy(&y, b, sizeof(y));
+    if (x.low != y.low)
+        return (x.low > y.low) - (x.low < y.low);
+    if (x.high != y.high)
+        return (x.high > y.high) - (x.high < y.high);
+    return ((uintptr_t) x.value > (uintptr_t) y.value) - ((uintptr_t) x.value < (uintptr_t) y.value);
+}
+
+//----------------------------------------
+/*
+ * Initialise un arbre d'intervalles vide. Les noeuds sont pris dans 'pool' s'il est non
+ * nul (pool cree pour des donnees de sizeof(AVLInterval) octets).
+ */
+void    AVLinterval_init(AVLIntervalTree *tree, AVLPool *pool) {
+    tree->root = NULL;
+    tree->ops = (AVLOps) { .cmp3 = AVLinterval_compare3, .pool = pool, .augment = AVLinterval_augment };
+    tree->count = 0;
+}
+
+/*
+ * Libere tous les noeuds ; l'arbre reste utilisable.
+ */
+void    AVLinterval_destroy(AVLIntervalTree *tree) {
+    AVLtree_deleteTreeOps(&tree->root, &tree->ops);
+    tree->count = 0;
+}
+
+size_t  AVLinterval_getSize(const AVLIntervalTree *tree) {
+    return tree->count;
+}
+
+/*
+ * Renvoie une copie alignee de l'intervalle range dans 'node'.
+ */
+AVLInterval AVLinterval_get(const AVLTree node) {
+    AVLInterval interval;
+
+    memcpy(&interval, node->data, sizeof(interval));
+    return interval;
+}
+
+//----------------------------------------
+/*
+ * Ajoute [low, high] avec 'value'. Renvoie false si low > high, si le meme intervalle est
+ * deja range avec la meme valeur, ou en cas d'echec d'allocation.
+ */
+bool    AVLinterval_insert(AVLIntervalTree *tree, int64_t low, int64_t high, void *value) {
+    AVLInterval interval = { low, high, high, value };
+    AVLPath     path;
+    AVLTree     node;
+
+    if (low > high || AVLtree_pathFind(&tree->root, &tree->ops, &interval, &path))
+        return false;
+    if (!(node = AVLtree_allocNode(&tree->ops, sizeof(interval))))
+        return false;
+    memcpy(node->data, &interval, sizeof(interval));
+    AVLtree_pathInsert(&path, &tree->ops, node);
+    tree->count++;
+    return true;
+}
+
+/*
+ * Retire [low, high] range avec 'value'. Renvoie false s'il est absent.
+ */
+bool    AVLinterval_delete(AVLIntervalTree *tree, int64_t low, int64_t high, void *value) {
+    AVLInterval interval = { low, high, high, value };
+    AVLPath     path;
+
+    if (!AVLtree_pathFind(&tree->root, &tree->ops, &interval, &path))
+        return false;
+    AVLtree_freeNode(&tree->ops, AVLtree_pathRemove(&path, &tree->ops));
+    tree->count--;
+    return true;
+}
+
+//----------------------------------------
+/*
+ * Parcours infixe limite aux sous-arbres qui peuvent contenir un intervalle qui chevauche
+ * la requete. Renvoie false des que la fonction de l'appelant a demande l'arret.
+ */
+static bool AVLinterval_search(const AVLTree node, AVLIntervalQuery *query) {
+    AVLInterval interval;
+
+    if (!node || AVLinterval_maxHigh(node) < query->low)
+        return true;
+    if (!AVLinterval_search(node->left, query))
+        return false;
+
+    //tout le sous-arbre droit commence apres ce noeud
+    interval = AVLinterval_get(node);
+    if (interval.low > query->high)
+        return true;
+    if (interval.high >= query->low) {
+        query->nbVisited++;
+        if (!query->func(&interval, query->extra_data))
+            return false;
+    }
+    return AVLinterval_search(node->right, query);
+}
+
+/*
+ * Applique 'func' a chaque intervalle qui chevauche [low, high] (bornes comprises), par
+ * debut croissant, tant que 'func' renvoie true. Renvoie le nombre d'intervalles passes a
+ * 'func'.
+ * Seuls sont visites les noeuds des deux chemins qui bornent la requete et les ancetres
+ * des intervalles trouves : O(log n) sans resultat, O((k + 1) log n) au pire pour k
+ * resultats, et bien moins quand les resultats sont groupes.
+ */
+size_t  AVLinterval_overlap(const AVLIntervalTree *tree, int64_t low, int64_t high,
+                            bool (*func)(const AVLInterval *, void *), void *extra_data) {
+    AVLIntervalQuery query = { low, high, func, extra_data, 0 };
+
+    if (low <= high)
+        AVLinterval_search(tree->root, &query);
+    return query.nbVisited;
+}
+
+/*
+ * Applique 'func' a chaque intervalle qui contient 'point' (voir #AVLinterval_overlap()).
+ */
+size_t  AVLinterval_stab(const AVLIntervalTree *tree, int64_t point,
+                         bool (*func)(const AVLInterval *, void *), void *extra_data) {
+    return AVLinterval_overlap(tree, point, point, func, extra_data);
+}
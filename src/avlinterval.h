@@ -0,0 +1,55 @@
+#ifndef _AVLINTERVAL_H_
+#define _AVLINTERVAL_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "avltree.h"
+
+
+/*
+ * Intervalle ferme [low, high] associe a une valeur de l'appelant. 'maxHigh' est
+ * l'augmentation : la plus grande borne 'high' du sous-arbre du noeud, tenue a jour par le
+ * moteur (voir 'augment' dans AVLOps).
+ */
+typedef struct AVLInterval AVLInterval;
+struct          AVLInterval {
+        int64_t         low;
+        int64_t         high;
+        int64_t         maxHigh;
+        void            *value;
+};
+
+/*
+ * Arbre d'intervalles : AVL ordonne par (low, high, value), dont chaque noeud connait la
+ * plus grande borne haute de son sous-arbre. Une recherche de chevauchement ignore tout
+ * sous-arbre dont 'maxHigh' est avant le debut de la requete, et tout sous-arbre droit
+ * d'un noeud qui commence apres sa fin.
+ * Un meme intervalle peut etre range plusieurs fois avec des valeurs differentes.
+ */
+typedef struct AVLIntervalTree AVLIntervalTree;
+struct          AVLIntervalTree {
+        AVLTree         root;
+        AVLOps          ops;
+        size_t          count;
+};
+
+/*--------------------------------------------------------------------*/
+void    AVLinterval_init(AVLIntervalTree *tree, AVLPool *pool);
+void    AVLinterval_destroy(AVLIntervalTree *tree);
+size_t  AVLinterval_getSize(const AVLIntervalTree *tree);
+AVLInterval AVLinterval_get(const AVLTree node);
+
+//----------------------------------------
+bool    AVLinterval_insert(AVLIntervalTree *tree, int64_t low, int64_t high, void *value);
+bool    AVLinterval_delete(AVLIntervalTree *tree, int64_t low, int64_t high, void *value);
+
+//----------------------------------------
+size_t  AVLinterval_overlap(const AVLIntervalTree *tree, int64_t low, int64_t high,
+                            bool (*func)(const AVLInterval *, void *), void *extra_data);
+size_t  AVLinterval_stab(const AVLIntervalTree *tree, int64_t point,
+                         bool (*func)(const AVLInterval *, void *), void *extra_data);
+/*--------------------------------------------------------------------*/
+
+#endif
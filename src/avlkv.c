@@ -0,0 +1,186 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "avlkv.h"
+#include "avlcursor.h"
+
+
+#define AVLKV_ALIGN         8
+#define AVLKV_ROUND(x)      (((x) + AVLKV_ALIGN - 1) / AVLKV_ALIGN * AVLKV_ALIGN)
+
+/*
+ * Initialise un dictionnaire vide. 'cmp3' compare deux cles de 'keySize' octets.
+ * La position de la valeur est arrondie depuis le debut du noeud et non depuis 'data',
+ * dont le decalage depend des champs compiles (voir AVLTREE_ORDER_STATISTIC).
+ */
+bool    AVLkv_init(AVLKV *kv, size_t keySize, size_t valueSize, AVLKVStorage storage,
+                   int (*cmp3)(const void *, const void *)) {
+    if (!kv || !keySize || !cmp3)
+        return false;
+
+    kv->root = NULL;
+    kv->ops = (AVLOps) { .cmp3 = cmp3 };
+    kv->keySize = keySize;
+    kv->valueSize = valueSize;
+    kv->valueOffset = AVLKV_ROUND(offsetof(struct AVLTreeNode, data) + keySize) - offsetof(struct AVLTreeNode, data);
+    kv->storage = storage;
+    return true;
+}
+
+/*
+ * Taille de la donnee d'un noeud : la cle, puis la valeur ou l'adresse de son bloc.
+ */
+static size_t AVLkv_dataSize(const AVLKV *kv) {
+    if (kv->storage == AVLKV_INLINE)
+        return kv->valueOffset + kv->valueSize;
+    return kv->valueOffset + sizeof(void *);
+}
+
+/*
+ * Detruit la valeur d'un noeud decroche avec 'destroy' (optionnel) puis libere le bloc de
+ * la valeur et le noeud.
+ */
+static void AVLkv_freeNode(AVLKV *kv, AVLTree node, void (*destroy)(void *, void *), void *extra_data) {
+    void *value = AVLkv_getValue(kv, node);
+
+    if (destroy)
+        destroy(value, extra_data);
+    if (kv->storage == AVLKV_OUT_OF_LINE)
+        free(value);
+    AVLtree_freeNode(&kv->ops, node);
+}
+
+/*
+ * Vide le dictionnaire, en appelant 'destroy' (optionnel) sur chaque valeur.
+ * Meme parcours sans pile que #AVLtree_deleteSubtree().
+ */
+void    AVLkv_destroy(AVLKV *kv, void (*destroy)(void *, void *), void *extra_data) {
+    AVLTree node, oNode;
+
+    node = kv->root;
+    while (node) {
+        if (node->left) {
+            oNode = node->left;
+            node->left = oNode->right;
+            oNode->right = node;
+            node = oNode;
+        } else {
+            oNode = node->right;
+            AVLkv_freeNode(kv, node, destroy, extra_data);
+            node = oNode;
+        }
+    }
+    kv->root = NULL;
+}
+
+//----------------------------------------
+/*
+ * Renvoie le nombre de cles.
+ */
+size_t  AVLkv_getSize(const AVLKV *kv) {
+    return AVLtree_getSize(kv->root);
+}
+
+/*
+ * Renvoie la valeur du noeud 'node' (obtenu par exemple avec un curseur sur 'kv->root').
+ */
+void    *AVLkv_getValue(const AVLKV *kv, const AVLTree node) {
+    if (!node)
+        return NULL;
+    if (kv->storage == AVLKV_INLINE)
+        return node->data + kv->valueOffset;
+    return *(void **) (node->data + kv->valueOffset);
+}
+
+/*
+ * Renvoie la valeur associee a 'key', ou NULL.
+ */
+void    *AVLkv_get(const AVLKV *kv, const void *key) {
+    return AVLkv_getValue(kv, AVLtree_searchOps(kv->root, &kv->ops, key));
+}
+
+//----------------------------------------
+/*
+ * Renvoie la valeur associee a 'key', en la creant si la cle est absente.
+ * A la creation, seule la cle est copiee ; la valeur est construite sur place par
+ * 'construct(value, extra_data)' (si 'construct' est nul, elle est laissee a remplir par
+ * l'appelant). Si 'construct' renvoie false, rien n'est insere et NULL est renvoye.
+ * '*inserted' (optionnel) indique si la cle vient d'etre ajoutee. Renvoie aussi NULL si
+ * la memoire manque.
+ */
+void    *AVLkv_emplace(AVLKV *kv, const void *key, bool (*construct)(void *, void *), void *extra_data,
+                       bool *inserted) {
+    AVLPath path;
+    AVLTree node;
+    void    *value;
+
+    if (inserted)
+        *inserted = false;
+    if ((node = AVLtree_pathFind(&kv->root, &kv->ops, key, &path)))
+        return AVLkv_getValue(kv, node);
+
+    if (!(node = AVLtree_allocNode(&kv->ops, AVLkv_dataSize(kv))))
+        return NULL;
+    memcpy(node->data, key, kv->keySize);
+    if (kv->storage == AVLKV_INLINE) {
+        value = node->data + kv->valueOffset;
+    } else if ((value = malloc(kv->valueSize ? kv->valueSize : 1))) {
+        *(void **) (node->data + kv->valueOffset) = value;
+    } else {
+        AVLtree_freeNode(&kv->ops, node);
+        return NULL;
+    }
+
+    if (construct && !construct(value, extra_data)) {
+        if (kv->storage == AVLKV_OUT_OF_LINE)
+            free(value);
+        AVLtree_freeNode(&kv->ops, node);
+        return NULL;
+    }
+    AVLtree_pathInsert(&path, &kv->ops, node);
+    if (inserted)
+        *inserted = true;
+    return value;
+}
+
+/*
+ * Associe une copie de 'value' a 'key', en remplacant l'ancienne valeur s'il y en a une.
+ * Renvoie false si la memoire manque.
+ */
+bool    AVLkv_put(AVLKV *kv, const void *key, const void *value) {
+    void *slot;
+
+    if (!(slot = AVLkv_emplace(kv, key, NULL, NULL, NULL)))
+        return false;
+    memcpy(slot, value, kv->valueSize);
+    return true;
+}
+
+/*
+ * Supprime 'key' et sa valeur, apres avoir appele 'destroy' (optionnel) sur celle-ci.
+ * Le noeud est decroche par #AVLtree_pathRemove() : aucune valeur n'est deplacee.
+ * Renvoie false si la cle est absente.
+ */
+bool    AVLkv_delete(AVLKV *kv, const void *key, void (*destroy)(void *, void *), void *extra_data) {
+    AVLPath path;
+
+    if (!AVLtree_pathFind(&kv->root, &kv->ops, key, &path))
+        return false;
+    AVLkv_freeNode(kv, AVLtree_pathRemove(&path, &kv->ops), destroy, extra_data);
+    return true;
+}
+
+//----------------------------------------
+/*
+ * Parcours par ordre croissant des cles ; 'func(key, value, extra_data)' renvoie false
+ * pour arreter le parcours.
+ */
+void    AVLkv_in_order(const AVLKV *kv, bool (*func)(const void *, void *, void *), void *extra_data) {
+    AVLCursor   cursor;
+    bool        valid;
+
+    AVLcursor_init(&cursor, kv->root);
+    for (valid = AVLcursor_first(&cursor); valid; valid = AVLcursor_next(&cursor))
+        if (!func(AVLcursor_getData(&cursor), AVLkv_getValue(kv, AVLcursor_getNode(&cursor)), extra_data))
+            break;
+}
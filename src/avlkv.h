@@ -0,0 +1,59 @@
+#ifndef _AVLKV_H_
+#define _AVLKV_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "avltree.h"
+
+
+/*
+ * Dictionnaire cle/valeur sur le moteur de avltree.c. La cle, de taille fixe, est rangee
+ * en tete de la donnee du noeud et seule elle est comparee. La valeur est :
+ *  - soit dans le noeud, juste apres la cle (AVLKV_INLINE) ;
+ *  - soit dans un bloc a part dont le noeud ne garde que l'adresse (AVLKV_OUT_OF_LINE) :
+ *    une recherche ne touche alors que des noeuds de la taille de la cle.
+ * Les valeurs ne sont jamais recopiees par l'arbre : #AVLkv_emplace() les construit
+ * directement dans la memoire de l'arbre, et une suppression decroche le noeud en
+ * modifiant les liens. L'adresse d'une valeur (ou de son bloc) est alignee sur 8 octets.
+ * Les noeuds viennent de 'ops.pool' s'il est renseigne, avec des donnees de
+ * 'valueOffset + valueSize' octets (AVLKV_INLINE) ou 'valueOffset + sizeof(void *)'.
+ * 'root' est un AVLTree ordinaire : curseurs et parcours s'y appliquent, la valeur d'un
+ * noeud s'obtenant avec #AVLkv_getValue().
+ */
+typedef enum AVLKVStorage {
+        AVLKV_INLINE,
+        AVLKV_OUT_OF_LINE
+} AVLKVStorage;
+
+typedef struct AVLKV AVLKV;
+struct          AVLKV {
+        AVLTree         root;
+        AVLOps          ops;
+        size_t          keySize;
+        size_t          valueSize;
+        size_t          valueOffset;
+        AVLKVStorage    storage;
+};
+
+/*--------------------------------------------------------------------*/
+bool    AVLkv_init(AVLKV *kv, size_t keySize, size_t valueSize, AVLKVStorage storage,
+                   int (*cmp3)(const void *, const void *));
+void    AVLkv_destroy(AVLKV *kv, void (*destroy)(void *, void *), void *extra_data);
+
+//----------------------------------------
+size_t  AVLkv_getSize(const AVLKV *kv);
+void    *AVLkv_getValue(const AVLKV *kv, const AVLTree node);
+void    *AVLkv_get(const AVLKV *kv, const void *key);
+
+//----------------------------------------
+void    *AVLkv_emplace(AVLKV *kv, const void *key, bool (*construct)(void *, void *), void *extra_data,
+                       bool *inserted);
+bool    AVLkv_put(AVLKV *kv, const void *key, const void *value);
+bool    AVLkv_delete(AVLKV *kv, const void *key, void (*destroy)(void *, void *), void *extra_data);
+
+//----------------------------------------
+void    AVLkv_in_order(const AVLKV *kv, bool (*func)(const void *, void *, void *), void *extra_data);
+/*--------------------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,292 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "avlmapped.h"
+
+
+#define AVLMAPPED_VERSION       1
+#define AVLMAPPED_ALIGN         8
+#define AVLMAPPED_ROUND(x)      (((x) + AVLMAPPED_ALIGN - 1) / AVLMAPPED_ALIGN * AVLMAPPED_ALIGN)
+
+/*
+ * Ecrit 'tree' (donnees de 'elemSize' octets) dans le fichier 'path'.
+ * Les noeuds sont numerotes dans l'ordre d'un parcours en largeur : un noeud recoit
+ * l'indice de ses fils au moment ou ils sont mis dans la file, avant d'etre ecrit.
+ * Renvoie false en cas d'erreur d'allocation ou d'ecriture (le fichier est alors incomplet).
+ */
+bool    AVLmapped_write(const AVLTree tree, size_t elemSize, const char *path) {
+    AVLMappedHeader header;
+    AVLMappedNode   *record;
+    AVLTree         *queue;
+    AVLTree         node;
+    FILE            *file;
+    size_t          count, nodeSize, head, tail;
+    bool            ok;
+
+    count = AVLtree_getSize(tree);
+    if (count > UINT32_MAX - 1)
+        return false;
+    nodeSize = AVLMAPPED_ROUND(sizeof(AVLMappedNode) + elemSize);
+
+    queue = (AVLTree *) malloc(sizeof(AVLTree) * (count ? count : 1));
+    record = (AVLMappedNode *) calloc(1, nodeSize);
+    file = (queue && record) ? fopen(path, "wb") : NULL;
+    if (!file) {
+        free(queue);
+        free(record);
+        return false;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, AVLMAPPED_MAGIC, sizeof(header.magic));
+    header.version = AVLMAPPED_VERSION;
+    header.byteOrder = AVLMAPPED_BYTE_ORDER;
+    header.elemSize = elemSize;
+    header.nodeSize = nodeSize;
+    header.nbNodes = count;
+    header.root = (tree) ? 1 : 0;
+    ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    head = 0;
+    tail = 0;
+    if (tree)
+        queue[tail++] = tree;
+    while (ok && head < tail) {
+        node = queue[head++];
+        record->left = 0;
+        record->right = 0;
+        if (node->left) {
+            queue[tail++] = node->left;
+            record->left = (uint32_t) tail;
+        }
+        if (node->right) {
+            queue[tail++] = node->right;
+            record->right = (uint32_t) tail;
+        }
+        memcpy((char *) record + sizeof(AVLMappedNode), node->data, elemSize);
+        ok = fwrite(record, nodeSize, 1, file) == 1;
+    }
+
+    ok = (fclose(file) == 0) && ok && head == count;
+    free(queue);
+    free(record);
+    return ok;
+}
+
+/*
+ * Projette en memoire le fichier 'path' ecrit par #AVLmapped_write(). Seul l'entete est
+ * lu et verifie : les noeuds ne sont charges qu'a la demande, quand une recherche ou un
+ * parcours y accede. Renvoie false si le fichier est illisible ou mal forme.
+ */
+bool    AVLmapped_open(AVLMapped *mapped, const char *path) {
+    const AVLMappedHeader   *header;
+    struct stat             info;
+    void                    *base;
+    int                     fd;
+
+    if ((fd = open(path, O_RDONLY)) < 0)
+        return false;
+    if (fstat(fd, &info) != 0 || (size_t) info.st_size < sizeof(AVLMappedHeader)) {
+        close(fd);
+        return false;
+    }
+    base = mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+        return false;
+
+    //aucune somme ni produit sur les champs lus : un fichier forge ne doit pas les faire deborder
+    header = (const AVLMappedHeader *) base;
+    if (memcmp(header->magic, AVLMAPPED_MAGIC, sizeof(header->magic)) != 0
+            || header->version != AVLMAPPED_VERSION || header->byteOrder != AVLMAPPED_BYTE_ORDER
+            || header->elemSize > UINT32_MAX || header->nodeSize > UINT32_MAX
+            || header->nodeSize < sizeof(AVLMappedNode) + header->elemSize || header->nodeSize % AVLMAPPED_ALIGN
+            || header->nbNodes > UINT32_MAX - 1 || header->root > header->nbNodes
+            || header->nbNodes > ((size_t) info.st_size - sizeof(AVLMappedHeader)) / header->nodeSize) {
+        munmap(base, (size_t) info.st_size);
+        return false;
+    }
+
+    //les recherches sautent d'un bout a l'autre du fichier : pas de lecture anticipee
+    posix_madvise(base, (size_t) info.st_size, POSIX_MADV_RANDOM);
+
+    mapped->base = (const char *) base;
+    mapped->length = (size_t) info.st_size;
+    mapped->elemSize = header->elemSize;
+    mapped->nodeSize = header->nodeSize;
+    mapped->nbNodes = (uint32_t) header->nbNodes;
+    mapped->root = (uint32_t) header->root;
+    return true;
+}
+
+/*
+ * Supprime la projection du fichier.
+ */
+void    AVLmapped_close(AVLMapped *mapped) {
+    if (mapped && mapped->base) {
+        munmap((void *) mapped->base, mapped->length);
+        mapped->base = NULL;
+        mapped->length = 0;
+        mapped->nbNodes = 0;
+        mapped->root = 0;
+    }
+}
+
+/*
+ * Renvoie le nombre d'elements, lu dans l'entete.
+ */
+size_t  AVLmapped_getSize(const AVLMapped *mapped) {
+    return mapped->nbNodes;
+}
+
+//----------------------------------------
+/*
+ * Renvoie le noeud d'indice 'index', ou NULL pour 0 ou un indice hors du fichier.
+ */
+const AVLMappedNode *AVLmapped_getNode(const AVLMapped *mapped, uint32_t index) {
+    if (index == 0 || index > mapped->nbNodes)
+        return NULL;
+    return (const AVLMappedNode *) (mapped->base + sizeof(AVLMappedHeader) + (size_t) (index - 1) * mapped->nodeSize);
+}
+
+/*
+ * Renvoie la donnee du noeud d'indice 'index', ou NULL.
+ */
+const void  *AVLmapped_getData(const AVLMapped *mapped, uint32_t index) {
+    const AVLMappedNode *node = AVLmapped_getNode(mapped, index);
+
+    if (!node)
+        return NULL;
+    return (const char *) node + sizeof(AVLMappedNode);
+}
+
+/*
+ * Renvoie la donnee egale a 'data', ou NULL. La descente est bornee par la hauteur
+ * maximale d'un AVL, ce qui protege d'un fichier corrompu.
+ */
+const void  *AVLmapped_search(const AVLMapped *mapped, int (*cmp3)(const void *, const void *), const void *data) {
+    const AVLMappedNode *node;
+    uint32_t            index;
+    int                 res, depth;
+
+    index = mapped->root;
+    for (depth = 0; depth < AVLTREE_MAX_HEIGHT && (node = AVLmapped_getNode(mapped, index)); depth++) {
+        if ((res = cmp3(data, (const char *) node + sizeof(AVLMappedNode))) == 0)
+            return (const char *) node + sizeof(AVLMappedNode);
+        index = (res < 0) ? node->left : node->right;
+    }
+    return NULL;
+}
+
+/*
+ * Parcours infixe ; s'arrete des que 'func' renvoie false.
+ */
+void    AVLmapped_in_order(const AVLMapped *mapped, bool (*func)(const void *, void *), void *extra_data) {
+    AVLMappedCursor cursor;
+    bool            valid;
+
+    AVLmapped_cursorInit(&cursor, mapped);
+    for (valid = AVLmapped_cursorFirst(&cursor); valid; valid = AVLmapped_cursorNext(&cursor))
+        if (!func(AVLmapped_cursorGetData(&cursor), extra_data))
+            break;
+}
+
+//----------------------------------------
+/*
+ * Place le curseur sur l'arbre projete, sans position courante.
+ */
+void    AVLmapped_cursorInit(AVLMappedCursor *cursor, const AVLMapped *mapped) {
+    cursor->mapped = mapped;
+    cursor->depth = 0;
+}
+
+bool    AVLmapped_cursorValid(const AVLMappedCursor *cursor) {
+    return cursor->depth > 0;
+}
+
+const void  *AVLmapped_cursorGetData(const AVLMappedCursor *cursor) {
+    if (cursor->depth == 0)
+        return NULL;
+    return AVLmapped_getData(cursor->mapped, cursor->stack[cursor->depth - 1]);
+}
+
+/*
+ * Empile 'index' puis toute la branche gauche qui en part. Un fichier corrompu plus
+ * profond qu'un AVL invalide le curseur.
+ */
+static bool AVLmapped_pushLeft(AVLMappedCursor *cursor, uint32_t index) {
+    const AVLMappedNode *node;
+
+    while ((node = AVLmapped_getNode(cursor->mapped, index))) {
+        if (cursor->depth == AVLTREE_MAX_HEIGHT) {
+            cursor->depth = 0;
+            return false;
+        }
+        cursor->stack[cursor->depth++] = index;
+        index = node->left;
+    }
+    return cursor->depth > 0;
+}
+
+/*
+ * Positionne le curseur sur le plus petit element. Renvoie false si l'arbre est vide.
+ */
+bool    AVLmapped_cursorFirst(AVLMappedCursor *cursor) {
+    cursor->depth = 0;
+    return AVLmapped_pushLeft(cursor, cursor->mapped->root);
+}
+
+/*
+ * Positionne le curseur sur le premier element superieur ou egal a 'data' (voir
+ * AVLcursor_lowerBound).
+ */
+bool    AVLmapped_cursorLowerBound(AVLMappedCursor *cursor, int (*cmp3)(const void *, const void *), const void *data) {
+    const AVLMappedNode *node;
+    uint32_t            index;
+    int                 found, res;
+
+    cursor->depth = 0;
+    found = 0;
+    index = cursor->mapped->root;
+    while (cursor->depth < AVLTREE_MAX_HEIGHT && (node = AVLmapped_getNode(cursor->mapped, index))) {
+        cursor->stack[cursor->depth++] = index;
+        res = cmp3(data, (const char *) node + sizeof(AVLMappedNode));
+        if (res <= 0) {
+            found = cursor->depth;
+            if (res == 0)
+                break;
+            index = node->left;
+        } else {
+            index = node->right;
+        }
+    }
+    cursor->depth = found;
+    return found > 0;
+}
+
+/*
+ * Avance le curseur sur l'element suivant dans l'ordre. Renvoie false a la fin de l'arbre.
+ */
+bool    AVLmapped_cursorNext(AVLMappedCursor *cursor) {
+    const AVLMappedNode *node;
+    uint32_t            index;
+
+    if (cursor->depth == 0)
+        return false;
+
+    node = AVLmapped_getNode(cursor->mapped, cursor->stack[cursor->depth - 1]);
+    if (node->right)
+        return AVLmapped_pushLeft(cursor, node->right);
+
+    do {
+        index = cursor->stack[--cursor->depth];
+    } while (cursor->depth > 0
+             && AVLmapped_getNode(cursor->mapped, cursor->stack[cursor->depth - 1])->right == index);
+    return cursor->depth > 0;
+}
@@ -0,0 +1,85 @@
+#ifndef _AVLMAPPED_H_
+#define _AVLMAPPED_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "avltree.h"
+
+
+/*
+ * Format de fichier d'un arbre en lecture seule, utilisable tel quel apres mmap().
+ * Le fichier commence par un entete de 64 octets, suivi des noeuds, tous de 'nodeSize'
+ * octets : deux indices de fils sur 32 bits puis la donnee, alignee sur 8 octets.
+ * Un indice designe le noeud place a 'sizeof(AVLMappedHeader) + (indice - 1) * nodeSize'
+ * dans le fichier, 0 tenant lieu de NULL : aucune adresse n'est ecrite, le fichier ne
+ * depend pas de l'endroit ou il est projete.
+ * Les noeuds sont ecrits niveau par niveau : les premiers niveaux, traverses par toutes
+ * les recherches, tiennent dans les premieres pages du fichier.
+ * Apres #AVLmapped_open(), recherches, curseurs et parcours lisent directement les pages
+ * projetees : seules les pages touchees sont chargees.
+ */
+#define AVLMAPPED_MAGIC         "AVLTMAP1"
+#define AVLMAPPED_BYTE_ORDER    0x01020304u
+
+typedef struct AVLMappedHeader AVLMappedHeader;
+struct          AVLMappedHeader {
+        char            magic[8];
+        uint32_t        version;
+        uint32_t        byteOrder;
+        uint64_t        elemSize;
+        uint64_t        nodeSize;
+        uint64_t        nbNodes;
+        uint64_t        root;
+        uint64_t        reserved[2];
+};
+
+typedef struct AVLMappedNode AVLMappedNode;
+struct          AVLMappedNode {
+        uint32_t        left;
+        uint32_t        right;
+};
+
+typedef struct AVLMapped AVLMapped;
+struct          AVLMapped {
+        const char      *base;
+        size_t          length;
+        size_t          elemSize;
+        size_t          nodeSize;
+        uint32_t        nbNodes;
+        uint32_t        root;
+};
+
+/*
+ * Curseur ordonne sur un arbre projete, meme principe que AVLCursor.
+ */
+typedef struct AVLMappedCursor AVLMappedCursor;
+struct          AVLMappedCursor {
+        const AVLMapped *mapped;
+        uint32_t        stack[AVLTREE_MAX_HEIGHT];
+        int             depth;
+};
+
+/*--------------------------------------------------------------------*/
+bool    AVLmapped_write(const AVLTree tree, size_t elemSize, const char *path);
+bool    AVLmapped_open(AVLMapped *mapped, const char *path);
+void    AVLmapped_close(AVLMapped *mapped);
+size_t  AVLmapped_getSize(const AVLMapped *mapped);
+
+//----------------------------------------
+const AVLMappedNode *AVLmapped_getNode(const AVLMapped *mapped, uint32_t index);
+const void  *AVLmapped_getData(const AVLMapped *mapped, uint32_t index);
+const void  *AVLmapped_search(const AVLMapped *mapped, int (*cmp3)(const void *, const void *), const void *data);
+void    AVLmapped_in_order(const AVLMapped *mapped, bool (*func)(const void *, void *), void *extra_data);
+
+//----------------------------------------
+void    AVLmapped_cursorInit(AVLMappedCursor *cursor, const AVLMapped *mapped);
+bool    AVLmapped_cursorValid(const AVLMappedCursor *cursor);
+const void  *AVLmapped_cursorGetData(const AVLMappedCursor *cursor);
+bool    AVLmapped_cursorFirst(AVLMappedCursor *cursor);
+bool    AVLmapped_cursorLowerBound(AVLMappedCursor *cursor, int (*cmp3)(const void *, const void *), const void *data);
+bool    AVLmapped_cursorNext(AVLMappedCursor *cursor);
+/*--------------------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,173 @@
+#include <string.h>
+
+#include "avlmultiset.h"
+#include "avlcursor.h"
+
+
+#define AVLMULTISET_ROUND(x)    (((x) + sizeof(size_t) - 1) / sizeof(size_t) * sizeof(size_t))
+
+/*
+ * Initialise un multi-ensemble vide. 'cmp3' compare deux elements de 'elemSize' octets.
+ */
+bool    AVLmultiset_init(AVLMultiset *set, size_t elemSize, int (*cmp3)(const void *, const void *)) {
+    if (!set || !cmp3)
+        return false;
+
+    set->root = NULL;
+    set->ops = (AVLOps) { .cmp3 = cmp3 };
+    set->elemSize = elemSize;
+    set->countOffset = AVLMULTISET_ROUND(elemSize);
+    set->nbDistinct = 0;
+    set->total = 0;
+    return true;
+}
+
+/*
+ * Libere tous les noeuds ; le multi-ensemble reste utilisable.
+ */
+void    AVLmultiset_destroy(AVLMultiset *set) {
+    AVLtree_deleteTreeOps(&set->root, &set->ops);
+    set->nbDistinct = 0;
+    set->total = 0;
+}
+
+//----------------------------------------
+/*
+ * Renvoie le nombre total d'occurrences, en temps constant.
+ */
+size_t  AVLmultiset_getSize(const AVLMultiset *set) {
+    return set->total;
+}
+
+/*
+ * Renvoie le nombre d'elements distincts (de noeuds), en temps constant.
+ */
+size_t  AVLmultiset_getDistinct(const AVLMultiset *set) {
+    return set->nbDistinct;
+}
+
+/*
+ * Renvoie le nombre d'occurrences de la donnee de 'node' (0 pour un noeud nul).
+ * Le compteur est lu par memcpy : la donnee d'un noeud n'est pas forcement alignee.
+ */
+size_t  AVLmultiset_getCount(const AVLMultiset *set, const AVLTree node) {
+    size_t count;
+
+    if (!node)
+        return 0;
+    memcpy(&count, node->data + set->countOffset, sizeof(count));
+    return count;
+}
+
+static void AVLmultiset_setCount(const AVLMultiset *set, AVLTree node, size_t count) {
+    memcpy(node->data + set->countOffset, &count, sizeof(count));
+}
+
+/*
+ * Renvoie le nombre d'occurrences de 'data', 0 s'il est absent.
+ */
+size_t  AVLmultiset_count(const AVLMultiset *set, const void *data) {
+    return AVLmultiset_getCount(set, AVLtree_searchOps(set->root, &set->ops, data));
+}
+
+//----------------------------------------
+/*
+ * Ajoute 'count' occurrences de 'data' : un element present voit seulement son compteur
+ * augmenter, sans allocation ni reequilibrage. Renvoie le nouveau nombre d'occurrences,
+ * ou 0 si la memoire manque (ou si 'count' est nul et 'data' absent).
+ */
+size_t  AVLmultiset_insertMany(AVLMultiset *set, const void *data, size_t count) {
+    AVLPath path;
+    AVLTree node;
+
+    if ((node = AVLtree_pathFind(&set->root, &set->ops, data, &path))) {
+        count += AVLmultiset_getCount(set, node);
+        set->total += count - AVLmultiset_getCount(set, node);
+        AVLmultiset_setCount(set, node, count);
+        return count;
+    }
+    if (!count || !(node = AVLtree_allocNode(&set->ops, set->countOffset + sizeof(size_t))))
+        return 0;
+
+    memcpy(node->data, data, set->elemSize);
+    AVLmultiset_setCount(set, node, count);
+    AVLtree_pathInsert(&path, &set->ops, node);
+    set->nbDistinct++;
+    set->total += count;
+    return count;
+}
+
+size_t  AVLmultiset_insert(AVLMultiset *set, const void *data) {
+    return AVLmultiset_insertMany(set, data, 1);
+}
+
+/*
+ * Retire une occurrence de 'data' ; le noeud n'est decroche qu'a la derniere.
+ * Renvoie le nombre d'occurrences restantes, ou (size_t) -1 si 'data' est absent.
+ */
+size_t  AVLmultiset_delete(AVLMultiset *set, const void *data) {
+    AVLPath path;
+    AVLTree node;
+    size_t  count;
+
+    if (!(node = AVLtree_pathFind(&set->root, &set->ops, data, &path)))
+        return (size_t) -1;
+
+    set->total--;
+    if ((count = AVLmultiset_getCount(set, node) - 1)) {
+        AVLmultiset_setCount(set, node, count);
+        return count;
+    }
+    AVLtree_freeNode(&set->ops, AVLtree_pathRemove(&path, &set->ops));
+    set->nbDistinct--;
+    return 0;
+}
+
+/*
+ * Retire toutes les occurrences de 'data'. Renvoie le nombre d'occurrences retirees.
+ */
+size_t  AVLmultiset_deleteAll(AVLMultiset *set, const void *data) {
+    AVLPath path;
+    AVLTree node;
+    size_t  count;
+
+    if (!(node = AVLtree_pathFind(&set->root, &set->ops, data, &path)))
+        return 0;
+
+    count = AVLmultiset_getCount(set, node);
+    AVLtree_freeNode(&set->ops, AVLtree_pathRemove(&path, &set->ops));
+    set->nbDistinct--;
+    set->total -= count;
+    return count;
+}
+
+//----------------------------------------
+/*
+ * Parcours par ordre croissant des elements distincts ; 'func(data, count, extra_data)'
+ * recoit le nombre d'occurrences et renvoie false pour arreter le parcours.
+ */
+void    AVLmultiset_in_order(const AVLMultiset *set, bool (*func)(const void *, size_t, void *), void *extra_data) {
+    AVLCursor   cursor;
+    bool        valid;
+
+    AVLcursor_init(&cursor, set->root);
+    for (valid = AVLcursor_first(&cursor); valid; valid = AVLcursor_next(&cursor))
+        if (!func(AVLcursor_getData(&cursor), AVLmultiset_getCount(set, AVLcursor_getNode(&cursor)), extra_data))
+            break;
+}
+
+/*
+ * Parcours par ordre croissant ou chaque element est presente autant de fois qu'il a
+ * d'occurrences ; 'func(data, extra_data)' renvoie false pour arreter le parcours.
+ */
+void    AVLmultiset_in_order_expand(const AVLMultiset *set, bool (*func)(const void *, void *), void *extra_data) {
+    AVLCursor   cursor;
+    size_t      count;
+    bool        valid;
+
+    AVLcursor_init(&cursor, set->root);
+    for (valid = AVLcursor_first(&cursor); valid; valid = AVLcursor_next(&cursor))
+        for (count = AVLmultiset_getCount(set, AVLcursor_getNode(&cursor)); count; count--)
+            if (!func(AVLcursor_getData(&cursor), extra_data))
+                return;
+}
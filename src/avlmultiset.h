@@ -0,0 +1,54 @@
+#ifndef _AVLMULTISET_H_
+#define _AVLMULTISET_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "avltree.h"
+
+
+/*
+ * Multi-ensemble sur le moteur de avltree.c : un seul noeud par element distinct, qui
+ * compte ses occurrences. #AVLmultiset_insert() incremente le compteur d'un element deja
+ * present au lieu de l'ignorer, #AVLmultiset_delete() le decremente et ne retire le noeud
+ * qu'a la derniere occurrence. La memoire depend du nombre d'elements distincts, pas du
+ * nombre d'insertions.
+ * Le compteur est range dans la donnee du noeud, apres l'element (a 'countOffset') : le
+ * comparateur ne voit que l'element, et 'root' reste un AVLTree ordinaire sur lequel
+ * curseurs et parcours s'appliquent, le compteur d'un noeud s'obtenant avec
+ * #AVLmultiset_getCount().
+ * Les noeuds viennent de 'ops.pool' s'il est renseigne, avec des donnees de
+ * 'countOffset + sizeof(size_t)' octets.
+ */
+typedef struct AVLMultiset AVLMultiset;
+struct          AVLMultiset {
+        AVLTree         root;
+        AVLOps          ops;
+        size_t          elemSize;
+        size_t          countOffset;
+        size_t          nbDistinct;
+        size_t          total;
+};
+
+/*--------------------------------------------------------------------*/
+bool    AVLmultiset_init(AVLMultiset *set, size_t elemSize, int (*cmp3)(const void *, const void *));
+void    AVLmultiset_destroy(AVLMultiset *set);
+
+//----------------------------------------
+size_t  AVLmultiset_getSize(const AVLMultiset *set);
+size_t  AVLmultiset_getDistinct(const AVLMultiset *set);
+size_t  AVLmultiset_getCount(const AVLMultiset *set, const AVLTree node);
+size_t  AVLmultiset_count(const AVLMultiset *set, const void *data);
+
+//----------------------------------------
+size_t  AVLmultiset_insert(AVLMultiset *set, const void *data);
+size_t  AVLmultiset_insertMany(AVLMultiset *set, const void *data, size_t count);
+size_t  AVLmultiset_delete(AVLMultiset *set, const void *data);
+size_t  AVLmultiset_deleteAll(AVLMultiset *set, const void *data);
+
+//----------------------------------------
+void    AVLmultiset_in_order(const AVLMultiset *set, bool (*func)(const void *, size_t, void *), void *extra_data);
+void    AVLmultiset_in_order_expand(const AVLMultiset *set, bool (*func)(const void *, void *), void *extra_data);
+/*--------------------------------------------------------------------*/
+
+#endif
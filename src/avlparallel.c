@@ -0,0 +1,157 @@
+#include <string.h>
+
+#include "avlparallel.h"
+#include "avlworkers.h"
+
+
+typedef struct {
+    AVLTree             tree;
+    const AVLReduceOps  *ops;
+    AVLWorkers          *workers;
+    char                *accs;
+    size_t              stride;
+} AVLReduceArgs;
+
+/*
+ * Place la valeur de depart dans un accumulateur.
+ */
+static void AVLtree_reduceInit(const AVLReduceOps *ops, void *acc) {
+    if (ops->identity)
+        memcpy(acc, ops->identity, ops->accSize);
+    else
+        memset(acc, 0, ops->accSize);
+}
+
+/*
+ * Ajoute a 'acc' les donnees de 'tree' dans l'ordre des cles, sur le thread appelant.
+ */
+static void AVLtree_reduceSequential(AVLTree tree, const AVLReduceOps *ops, void *acc) {
+    while (tree) {
+        AVLtree_reduceSequential(tree->left, ops, acc);
+        ops->map(acc, tree->data, ops->context);
+        tree = tree->right;
+    }
+}
+
+//----------------------------------------
+static void AVLtree_reduceUnordered(AVLTree tree, AVLReduceArgs *args);
+
+static void AVLtree_reduceUnorderedTask(void *arg) {
+    AVLReduceArgs *args = (AVLReduceArgs *) arg;
+
+    AVLtree_reduceUnordered(args->tree, args);
+}
+
+/*
+ * Chaque thread ajoute les donnees qu'il rencontre a son propre accumulateur : aucune
+ * allocation ni combinaison avant la fin.
+ */
+static void AVLtree_reduceUnordered(AVLTree tree, AVLReduceArgs *args) {
+    AVLReduceArgs   leftArgs;
+    AVLTask         task;
+    char            *acc;
+
+    if (!tree)
+        return;
+
+    acc = args->accs + AVLworkers_getIndex(args->workers) * args->stride;
+    if (AVLtree_getHeight(tree) <= AVLPARALLEL_GRAIN_HEIGHT) {
+        AVLtree_reduceSequential(tree, args->ops, acc);
+        return;
+    }
+
+    leftArgs = *args;
+    leftArgs.tree = tree->left;
+    AVLworkers_fork(args->workers, &task, AVLtree_reduceUnorderedTask, &leftArgs);
+    args->ops->map(acc, tree->data, args->ops->context);
+    AVLtree_reduceUnordered(tree->right, args);
+    AVLworkers_join(args->workers, &task);
+}
+
+/*
+ * Reduit 'tree' sur 'nbThreads' threads, sans ordre garanti (voir avlparallel.h).
+ */
+void    AVLtree_parallel_reduce(const AVLTree tree, const AVLReduceOps *ops, void *result, unsigned int nbThreads) {
+    AVLReduceArgs   args;
+    unsigned int    index;
+
+    args = (AVLReduceArgs) { tree, ops, NULL, NULL, (ops->accSize + 63) / 64 * 64 };
+    if (nbThreads > 1 && AVLtree_getHeight(tree) > AVLPARALLEL_GRAIN_HEIGHT
+            && (args.workers = AVLworkers_create(nbThreads - 1))) {
+        //un accumulateur par file, chacun sur ses propres lignes de cache
+        args.accs = (char *) aligned_alloc(64, args.stride * (AVLworkers_getSize(args.workers) + 1) + 64);
+    }
+
+    if (!args.accs) {
+        AVLworkers_destroy(args.workers);
+        AVLtree_reduceInit(ops, result);
+        AVLtree_reduceSequential(tree, ops, result);
+        return;
+    }
+
+    for (index = 0; index <= AVLworkers_getSize(args.workers); index++)
+        AVLtree_reduceInit(ops, args.accs + index * args.stride);
+    AVLtree_reduceUnordered(tree, &args);
+
+    memcpy(result, args.accs, ops->accSize);
+    for (index = 1; index <= AVLworkers_getSize(args.workers); index++)
+        ops->combine(result, args.accs + index * args.stride, ops->context);
+    AVLworkers_destroy(args.workers);
+    free(args.accs);
+}
+
+//----------------------------------------
+static void AVLtree_reduceOrdered(AVLTree tree, const AVLReduceOps *ops, AVLWorkers *workers, void *acc);
+
+static void AVLtree_reduceOrderedTask(void *arg) {
+    AVLReduceArgs *args = (AVLReduceArgs *) arg;
+
+    AVLtree_reduceOrdered(args->tree, args->ops, args->workers, args->accs);
+}
+
+/*
+ * Le sous-arbre droit est confie au pool avec un accumulateur neuf ; le thread appelant
+ * traite le sous-arbre gauche et la racine dans 'acc', puis y ajoute le resultat de droite.
+ * Faute de memoire pour cet accumulateur, le sous-arbre est traite sur place.
+ */
+static void AVLtree_reduceOrdered(AVLTree tree, const AVLReduceOps *ops, AVLWorkers *workers, void *acc) {
+    AVLReduceArgs   rightArgs;
+    AVLTask         task;
+    char            *right;
+
+    if (!tree)
+        return;
+    if (AVLtree_getHeight(tree) <= AVLPARALLEL_GRAIN_HEIGHT || !(right = (char *) malloc(ops->accSize + 1))) {
+        AVLtree_reduceSequential(tree, ops, acc);
+        return;
+    }
+
+    AVLtree_reduceInit(ops, right);
+    rightArgs = (AVLReduceArgs) { tree->right, ops, workers, right, 0 };
+    AVLworkers_fork(workers, &task, AVLtree_reduceOrderedTask, &rightArgs);
+    AVLtree_reduceOrdered(tree->left, ops, workers, acc);
+    ops->map(acc, tree->data, ops->context);
+    AVLworkers_join(workers, &task);
+
+    ops->combine(acc, right, ops->context);
+    free(right);
+}
+
+/*
+ * Reduit 'tree' sur 'nbThreads' threads en respectant l'ordre des cles (voir avlparallel.h).
+ */
+void    AVLtree_parallel_reduce_ordered(const AVLTree tree, const AVLReduceOps *ops, void *result,
+                                        unsigned int nbThreads) {
+    AVLWorkers  *workers;
+
+    AVLtree_reduceInit(ops, result);
+    workers = NULL;
+    if (nbThreads > 1 && AVLtree_getHeight(tree) > AVLPARALLEL_GRAIN_HEIGHT)
+        workers = AVLworkers_create(nbThreads - 1);
+
+    if (workers)
+        AVLtree_reduceOrdered(tree, ops, workers, result);
+    else
+        AVLtree_reduceSequential(tree, ops, result);
+    AVLworkers_destroy(workers);
+}
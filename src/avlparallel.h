@@ -0,0 +1,45 @@
+#ifndef _AVLPARALLEL_H_
+#define _AVLPARALLEL_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "avltree.h"
+
+
+/*
+ * Hauteur a partir de laquelle une reduction parallele confie un sous-arbre a un autre
+ * thread (2^12 noeuds environ par tache au minimum).
+ */
+#define AVLPARALLEL_GRAIN_HEIGHT        12
+
+/*
+ * Reduction d'un arbre, decrite par :
+ *  - 'accSize', la taille en octets d'un accumulateur (0 pour un simple parcours) ;
+ *  - 'identity', la valeur de depart de tout accumulateur (copiee, NULL pour des zeros) ;
+ *  - 'map(acc, data, context)', qui ajoute la donnee d'un noeud a l'accumulateur ;
+ *  - 'combine(acc, other, context)', qui ajoute a 'acc' l'accumulateur 'other' et reprend
+ *    ses ressources eventuelles ('other' est ensuite abandonne sans autre appel).
+ * Les sous-arbres sont repartis sur un pool a vol de taches (voir avlworkers.h).
+ * #AVLtree_parallel_reduce() tient un accumulateur par thread : l'ordre des appels n'est
+ * pas defini, 'combine' doit etre associative et commutative.
+ * #AVLtree_parallel_reduce_ordered() appelle 'map' dans l'ordre des cles a l'interieur
+ * d'une tache et combine toujours un accumulateur avec celui des cles qui le suivent :
+ * 'combine' doit seulement etre associative (une concatenation donne les donnees triees).
+ */
+typedef struct AVLReduceOps AVLReduceOps;
+struct          AVLReduceOps {
+        size_t          accSize;
+        const void      *identity;
+        void            (*map)(void *acc, const void *data, void *context);
+        void            (*combine)(void *acc, void *other, void *context);
+        void            *context;
+};
+
+/*--------------------------------------------------------------------*/
+void    AVLtree_parallel_reduce(const AVLTree tree, const AVLReduceOps *ops, void *result, unsigned int nbThreads);
+void    AVLtree_parallel_reduce_ordered(const AVLTree tree, const AVLReduceOps *ops, void *result,
+                                        unsigned int nbThreads);
+/*--------------------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,129 @@
+#include <stddef.h>
+
+#include "avlpersist.h"
+
+
+/*
+ * Les noeuds persistants portent leur compteur de references juste avant la structure
+ * 'AVLTreeNode', ce qui les laisse utilisables par toutes les fonctions de lecture.
+ */
+typedef struct AVLPersistNode {
+    atomic_size_t       refs;
+    struct AVLTreeNode  node;
+} AVLPersistNode;
+
+#define AVLPERSIST_HEADER(tree) ((AVLPersistNode *) ((char *) (tree) - offsetof(AVLPersistNode, node)))
+
+static AVLTree AVLpersist_alloc(void *context) {
+    AVLPersistent   *tree = (AVLPersistent *) context;
+    AVLPersistNode  *header;
+
+    header = (AVLPersistNode *) malloc(offsetof(AVLPersistNode, node) + AVLtree_nodeSize(tree->ops.elemSize));
+    if (!header)
+        return NULL;
+    atomic_init(&header->refs, 1);
+    atomic_fetch_add(&tree->nbNodes, 1);
+    return &header->node;
+}
+
+static void AVLpersist_retain(AVLTree node, void *context) {
+    atomic_fetch_add(&AVLPERSIST_HEADER(node)->refs, 1);
+}
+
+/*
+ * Abandonne une reference. Le dernier abandon libere le noeud et abandonne a son tour les
+ * references sur ses fils : on boucle sur le fils droit et on ne recurse que sur le gauche,
+ * la recursion reste donc bornee par la hauteur de l'arbre.
+ */
+static void AVLpersist_releaseNode(AVLTree node, void *context) {
+    AVLPersistent   *tree = (AVLPersistent *) context;
+    AVLTree         right;
+
+    while (node && atomic_fetch_sub(&AVLPERSIST_HEADER(node)->refs, 1) == 1) {
+        if (node->left)
+            AVLpersist_releaseNode(node->left, context);
+        right = node->right;
+        free(AVLPERSIST_HEADER(node));
+        atomic_fetch_sub(&tree->nbNodes, 1);
+        node = right;
+    }
+}
+
+//----------------------------------------
+/*
+ * Initialise un arbre persistant vide pour des donnees de 'elemSize' octets.
+ */
+bool    AVLpersist_init(AVLPersistent *tree, int (*cmp3)(const void *, const void *), size_t elemSize) {
+    if (!tree || !cmp3)
+        return false;
+
+    tree->root = NULL;
+    atomic_init(&tree->nbNodes, 0);
+    tree->ops = (AVLCopyOps) {
+        .cmp3 = cmp3,
+        .elemSize = elemSize,
+        .alloc = AVLpersist_alloc,
+        .retain = AVLpersist_retain,
+        .release = AVLpersist_releaseNode,
+        .context = tree
+    };
+    return true;
+}
+
+/*
+ * Abandonne la version courante. Les noeuds encore utilises par des versions retenues
+ * restent valides jusqu'a leur #AVLpersist_release().
+ */
+void    AVLpersist_destroy(AVLPersistent *tree) {
+    AVLpersist_releaseNode(tree->root, tree);
+    tree->root = NULL;
+}
+
+//----------------------------------------
+/*
+ * Insere 'data' dans une nouvelle version qui devient la version courante.
+ * Seuls les noeuds du chemin sont recopies. Renvoie false si 'data' etait deja present.
+ */
+bool    AVLpersist_insert(AVLPersistent *tree, const void *data) {
+    bool inserted;
+
+    tree->root = AVLcopy_insert(&tree->ops, tree->root, data, &inserted);
+    return inserted;
+}
+
+/*
+ * Retire 'data' dans une nouvelle version qui devient la version courante.
+ * Renvoie false si 'data' etait absent.
+ */
+bool    AVLpersist_delete(AVLPersistent *tree, const void *data) {
+    bool deleted;
+
+    tree->root = AVLcopy_delete(&tree->ops, tree->root, data, &deleted);
+    return deleted;
+}
+
+//----------------------------------------
+/*
+ * Retient la version courante et renvoie sa racine. Cout en O(1) : aucun noeud n'est copie.
+ * La version reste valide et inchangee jusqu'a #AVLpersist_release().
+ */
+AVLTree AVLpersist_snapshot(AVLPersistent *tree) {
+    if (tree->root)
+        AVLpersist_retain(tree->root, tree);
+    return tree->root;
+}
+
+/*
+ * Rend une version obtenue par #AVLpersist_snapshot(). Les noeuds qu'elle etait la derniere
+ * a utiliser sont liberes.
+ */
+void    AVLpersist_release(AVLPersistent *tree, AVLTree snapshot) {
+    AVLpersist_releaseNode(snapshot, tree);
+}
+
+/*
+ * Renvoie le nombre de noeuds vivants, toutes versions confondues.
+ */
+size_t  AVLpersist_getNbNodes(AVLPersistent *tree) {
+    return atomic_load(&tree->nbNodes);
+}
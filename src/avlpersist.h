@@ -0,0 +1,43 @@
+#ifndef _AVLPERSIST_H_
+#define _AVLPERSIST_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "avltree.h"
+#include "avlcopy.h"
+
+
+/*
+ * Arbre persistant : chaque insertion ou suppression produit une nouvelle version par copie
+ * de chemin (voir avlcopy.h) et laisse les versions precedentes intactes.
+ * Une version retenue par #AVLpersist_snapshot() est un 'AVLTree' ordinaire en lecture
+ * seule (recherche, curseurs, parcours) qui ne change plus, quelles que soient les ecritures
+ * suivantes. Les noeuds sont partages entre versions et comptent leurs references : un noeud
+ * est libere quand plus aucune version ne l'utilise.
+ * Les ecritures sur un meme arbre doivent etre serialisees par l'appelant ; les versions
+ * peuvent etre lues et rendues depuis n'importe quel thread.
+ */
+typedef struct AVLPersistent AVLPersistent;
+struct          AVLPersistent {
+        AVLTree         root;
+        AVLCopyOps      ops;
+        atomic_size_t   nbNodes;
+};
+
+/*--------------------------------------------------------------------*/
+bool    AVLpersist_init(AVLPersistent *tree, int (*cmp3)(const void *, const void *), size_t elemSize);
+void    AVLpersist_destroy(AVLPersistent *tree);
+
+//----------------------------------------
+bool    AVLpersist_insert(AVLPersistent *tree, const void *data);
+bool    AVLpersist_delete(AVLPersistent *tree, const void *data);
+
+//----------------------------------------
+AVLTree AVLpersist_snapshot(AVLPersistent *tree);
+void    AVLpersist_release(AVLPersistent *tree, AVLTree snapshot);
+size_t  AVLpersist_getNbNodes(AVLPersistent *tree);
+/*--------------------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,115 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "avlpool.h"
+
+
+/*
+ * Entete d'un slab. Les noeuds suivent directement l'entete, l'entete etant
+ * completee pour que le premier noeud reste aligne.
+ */
+struct AVLPoolSlab {
+    AVLPoolSlab *next;
+    max_align_t align[];
+};
+
+#define AVLPOOL_ALIGN   (_Alignof(max_align_t))
+#define AVLPOOL_ROUND(x)    (((x) + AVLPOOL_ALIGN - 1) / AVLPOOL_ALIGN * AVLPOOL_ALIGN)
+
+
+/*
+ * Initialise un allocateur de noeuds de taille fixe.
+ * Tous les noeuds d'un meme pool peuvent contenir une donnee d'au plus 'size' octets.
+ * Les noeuds sont decoupes dans des blocs ('slabs') de 'nodesPerSlab' noeuds
+ * (AVLPOOL_DEFAULT_SLAB si 0). Un pool est prevu pour un seul arbre : c'est ce qui
+ * permet de liberer l'arbre entier d'un coup avec #AVLpool_release().
+ */
+bool    AVLpool_init(AVLPool *pool, size_t size, size_t nodesPerSlab) {
+    if (!pool)
+        return false;
+
+    pool->dataSize = size;
+    pool->nodeSize = AVLPOOL_ROUND(AVLtree_nodeSize(size));
+    pool->nodesPerSlab = (nodesPerSlab) ? nodesPerSlab : AVLPOOL_DEFAULT_SLAB;
+    pool->slabs = NULL;
+    pool->bump = NULL;
+    pool->bumpEnd = NULL;
+    pool->freeList = NULL;
+    pool->nbNodes = 0;
+    return true;
+}
+
+//----------------------------------------
+/*
+ * Renvoie un noeud non initialise.
+ * On reutilise d'abord les noeuds liberes (liste libre intrusive : le premier mot du
+ * noeud libre pointe sur le suivant), puis on avance dans le slab courant.
+ * Un nouveau slab n'est alloue que lorsque le courant est epuise.
+ */
+AVLTree AVLpool_alloc(AVLPool *pool) {
+    AVLTree         node;
+    AVLPoolSlab     *slab;
+
+    if (pool->freeList) {
+        node = (AVLTree) pool->freeList;
+        pool->freeList = *(void **) pool->freeList;
+        pool->nbNodes++;
+        return node;
+    }
+
+    if (pool->bump == pool->bumpEnd) {
+        if (!(slab = (AVLPoolSlab *) malloc(sizeof(AVLPoolSlab) + pool->nodeSize * pool->nodesPerSlab)))
+            return NULL;
+        slab->next = pool->slabs;
+        pool->slabs = slab;
+        pool->bump = (char *) slab + sizeof(AVLPoolSlab);
+        pool->bumpEnd = pool->bump + pool->nodeSize * pool->nodesPerSlab;
+    }
+
+    node = (AVLTree) pool->bump;
+    pool->bump += pool->nodeSize;
+    pool->nbNodes++;
+    return node;
+}
+
+/*
+ * Rend un noeud au pool. Il est chaine en tete de la liste libre et sera le prochain
+ * noeud renvoye par #AVLpool_alloc().
+ */
+void    AVLpool_free(AVLPool *pool, AVLTree node) {
+    if (node) {
+        *(void **) node = pool->freeList;
+        pool->freeList = node;
+        pool->nbNodes--;
+    }
+}
+
+//----------------------------------------
+/*
+ * Renvoie le nombre de noeuds actuellement alloues dans le pool.
+ */
+size_t  AVLpool_getSize(const AVLPool *pool) {
+    if (pool)
+        return pool->nbNodes;
+    return 0;
+}
+
+/*
+ * Libere en bloc tous les slabs du pool, et donc tous les noeuds de l'arbre associe,
+ * sans parcourir l'arbre. Le pool reste utilisable ensuite.
+ */
+void    AVLpool_release(AVLPool *pool) {
+    AVLPoolSlab *slab;
+
+    if (!pool)
+        return;
+
+    while ((slab = pool->slabs)) {
+        pool->slabs = slab->next;
+        free(slab);
+    }
+    pool->bump = NULL;
+    pool->bumpEnd = NULL;
+    pool->freeList = NULL;
+    pool->nbNodes = 0;
+}
@@ -0,0 +1,36 @@
+#ifndef _AVLPOOL_H_
+#define _AVLPOOL_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "avltree.h"
+
+
+#define AVLPOOL_DEFAULT_SLAB    256
+
+typedef struct AVLPoolSlab AVLPoolSlab;
+struct          AVLPool {
+        size_t          nodeSize;
+        size_t          dataSize;
+        size_t          nodesPerSlab;
+        AVLPoolSlab     *slabs;
+        char            *bump;
+        char            *bumpEnd;
+        void            *freeList;
+        size_t          nbNodes;
+};
+
+/*--------------------------------------------------------------------*/
+bool    AVLpool_init(AVLPool *pool, size_t size, size_t nodesPerSlab);
+
+//----------------------------------------
+AVLTree AVLpool_alloc(AVLPool *pool);
+void    AVLpool_free(AVLPool *pool, AVLTree node);
+
+//----------------------------------------
+size_t  AVLpool_getSize(const AVLPool *pool);
+void    AVLpool_release(AVLPool *pool);
+/*--------------------------------------------------------------------*/
+
+#endif
@@ -0,0 +1,181 @@
+#define _GNU_SOURCE
+
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "avlreclaim.h"
+
+
+/*
+ * Nombre d'etapes de destruction entre deux mises a jour du compteur de noeuds liberes.
+ */
+#define AVLRECLAIM_STEPS        4096
+
+struct AVLReclaimer {
+    pthread_mutex_t lock;
+    pthread_cond_t  wakeUp;
+    pthread_cond_t  idle;
+    AVLTree         pending;
+    bool            busy;
+    bool            stop;
+    atomic_size_t   nbFreed;
+    pthread_t       thread;
+};
+
+/*
+ * Prend possession de '*tree' pour le detruire par etapes ; '*tree' est remis a NULL.
+ * Les noeuds sont liberes selon 'ops' (optionnel), qui est copie.
+ */
+void    AVLteardown_init(AVLTeardown *teardown, AVLTree *tree, const AVLOps *ops) {
+    teardown->pending = *tree;
+    teardown->ops = (ops) ? *ops : (AVLOps) { 0 };
+    teardown->nbFreed = 0;
+    *tree = NULL;
+}
+
+/*
+ * Poursuit la destruction sur au plus 'budget' etapes, donc au plus 'budget' noeuds
+ * liberes en un temps proportionnel a 'budget'. Une destruction complete demande au plus
+ * deux etapes par noeud. Renvoie true s'il reste des noeuds a liberer.
+ */
+bool    AVLteardown_step(AVLTeardown *teardown, size_t budget) {
+    teardown->nbFreed += AVLtree_deleteSubtreeSteps(&teardown->pending, &teardown->ops, budget);
+    return teardown->pending != NULL;
+}
+
+bool    AVLteardown_isDone(const AVLTeardown *teardown) {
+    return teardown->pending == NULL;
+}
+
+//----------------------------------------
+/*
+ * Boucle du thread de recuperation : detacher d'un coup tout ce qui a ete confie, le
+ * liberer hors verrou, recommencer. A l'arret, le travail en attente est termine.
+ */
+static void *AVLreclaimer_loop(void *arg) {
+    AVLReclaimer    *reclaimer = (AVLReclaimer *) arg;
+    AVLTree         tree;
+
+#ifdef SCHED_IDLE
+    //le thread ne tourne que sur un coeur libre : il ne preempte jamais celui qui lui confie un arbre
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &(struct sched_param) { .sched_priority = 0 });
+#endif
+    pthread_mutex_lock(&reclaimer->lock);
+    for (;;) {
+        while (!reclaimer->pending && !reclaimer->stop) {
+            reclaimer->busy = false;
+            pthread_cond_broadcast(&reclaimer->idle);
+            pthread_cond_wait(&reclaimer->wakeUp, &reclaimer->lock);
+        }
+        if (!reclaimer->pending)
+            break;
+        tree = reclaimer->pending;
+        reclaimer->pending = NULL;
+        reclaimer->busy = true;
+        pthread_mutex_unlock(&reclaimer->lock);
+
+        while (tree)
+            atomic_fetch_add(&reclaimer->nbFreed, AVLtree_deleteSubtreeSteps(&tree, NULL, AVLRECLAIM_STEPS));
+        pthread_mutex_lock(&reclaimer->lock);
+    }
+    reclaimer->busy = false;
+    pthread_cond_broadcast(&reclaimer->idle);
+    pthread_mutex_unlock(&reclaimer->lock);
+    return NULL;
+}
+
+/*
+ * Demarre un thread de recuperation. Renvoie NULL en cas d'echec.
+ */
+AVLReclaimer    *AVLreclaimer_create(void) {
+    AVLReclaimer *reclaimer;
+
+    if (!(reclaimer = (AVLReclaimer *) malloc(sizeof(AVLReclaimer))))
+        return NULL;
+
+    pthread_mutex_init(&reclaimer->lock, NULL);
+    pthread_cond_init(&reclaimer->wakeUp, NULL);
+    pthread_cond_init(&reclaimer->idle, NULL);
+    reclaimer->pending = NULL;
+    reclaimer->busy = false;
+    reclaimer->stop = false;
+    atomic_init(&reclaimer->nbFreed, 0);
+
+    if (pthread_create(&reclaimer->thread, NULL, AVLreclaimer_loop, reclaimer) != 0) {
+        pthread_cond_destroy(&reclaimer->idle);
+        pthread_cond_destroy(&reclaimer->wakeUp);
+        pthread_mutex_destroy(&reclaimer->lock);
+        free(reclaimer);
+        return NULL;
+    }
+    return reclaimer;
+}
+
+/*
+ * Termine les destructions en cours et en attente, puis arrete le thread.
+ */
+void            AVLreclaimer_destroy(AVLReclaimer *reclaimer) {
+    if (!reclaimer)
+        return;
+
+    pthread_mutex_lock(&reclaimer->lock);
+    reclaimer->stop = true;
+    pthread_cond_signal(&reclaimer->wakeUp);
+    pthread_mutex_unlock(&reclaimer->lock);
+    pthread_join(reclaimer->thread, NULL);
+
+    pthread_cond_destroy(&reclaimer->idle);
+    pthread_cond_destroy(&reclaimer->wakeUp);
+    pthread_mutex_destroy(&reclaimer->lock);
+    free(reclaimer);
+}
+
+/*
+ * Confie '*tree' au thread de recuperation et remet '*tree' a NULL. Aucune allocation :
+ * le travail deja en attente est accroche sous le plus petit noeud de l'arbre, qui n'a pas
+ * de fils gauche. Le verrou n'est tenu que pour deux affectations ; la recherche de ce
+ * noeud, hors verrou, est bornee par la hauteur de l'arbre.
+ * Sans thread de recuperation, l'arbre est detruit immediatement.
+ */
+void            AVLreclaimer_submit(AVLReclaimer *reclaimer, AVLTree *tree) {
+    AVLTree leftmost;
+
+    if (!*tree)
+        return;
+    if (!reclaimer) {
+        AVLtree_deleteSubtree(tree, NULL);
+        return;
+    }
+
+    for (leftmost = *tree; leftmost->left; leftmost = leftmost->left)
+        ;
+    pthread_mutex_lock(&reclaimer->lock);
+    leftmost->left = reclaimer->pending;
+    reclaimer->pending = *tree;
+    pthread_mutex_unlock(&reclaimer->lock);
+    pthread_cond_signal(&reclaimer->wakeUp);
+    *tree = NULL;
+}
+
+/*
+ * Attend que tous les arbres confies jusqu'ici soient liberes.
+ */
+void            AVLreclaimer_wait(AVLReclaimer *reclaimer) {
+    if (!reclaimer)
+        return;
+
+    pthread_mutex_lock(&reclaimer->lock);
+    while (reclaimer->pending || reclaimer->busy)
+        pthread_cond_wait(&reclaimer->idle, &reclaimer->lock);
+    pthread_mutex_unlock(&reclaimer->lock);
+}
+
+/*
+ * Renvoie le nombre de noeuds liberes par le thread de recuperation depuis sa creation.
+ */
+size_t          AVLreclaimer_getFreed(AVLReclaimer *reclaimer) {
+    if (!reclaimer)
+        return 0;
+    return atomic_load(&reclaimer->nbFreed);
+}
@@ -0,0 +1,46 @@
+#ifndef _AVLRECLAIM_H_
+#define _AVLRECLAIM_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "avltree.h"
+
+
+/*
+ * Destruction d'un arbre sans longue pause.
+ * #AVLteardown_init() detache l'arbre en temps constant ; chaque #AVLteardown_step()
+ * poursuit ensuite la destruction sur un nombre borne d'etapes, sans recursion ni pile
+ * (voir AVLtree_deleteSubtreeSteps), par exemple une fois par tour de boucle d'evenements.
+ */
+typedef struct AVLTeardown AVLTeardown;
+struct          AVLTeardown {
+        AVLTree         pending;
+        AVLOps          ops;
+        size_t          nbFreed;
+};
+
+/*
+ * Thread de recuperation : #AVLreclaimer_submit() lui confie un arbre detache et rend la
+ * main aussitot, la liberation se faisant en arriere-plan.
+ * Sous Linux, le thread a la priorite SCHED_IDLE : il n'utilise que le temps processeur
+ * laisse libre et ne retarde jamais l'appelant, meme sur un seul coeur.
+ * Les noeuds sont rendus par free() depuis un autre thread : les arbres alloues dans un
+ * pool (non partage entre threads) doivent etre detruits par #AVLtree_deleteTreeOps().
+ */
+typedef struct AVLReclaimer AVLReclaimer;
+
+/*--------------------------------------------------------------------*/
+void    AVLteardown_init(AVLTeardown *teardown, AVLTree *tree, const AVLOps *ops);
+bool    AVLteardown_step(AVLTeardown *teardown, size_t budget);
+bool    AVLteardown_isDone(const AVLTeardown *teardown);
+
+//----------------------------------------
+AVLReclaimer    *AVLreclaimer_create(void);
+void            AVLreclaimer_destroy(AVLReclaimer *reclaimer);
+void            AVLreclaimer_submit(AVLReclaimer *reclaimer, AVLTree *tree);
+void            AVLreclaimer_wait(AVLReclaimer *reclaimer);
+size_t          AVLreclaimer_getFreed(AVLReclaimer *reclaimer);
+/*--------------------------------------------------------------------*/
+
+#endif
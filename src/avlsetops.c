@@ -0,0 +1,415 @@
+#include "avlsetops.h"
+#include "avlworkers.h"
+
+
+/*
+ * Vrai si un travail selon 'ops' peut etre reparti sur plusieurs threads : ni le pool ni
+ * les compteurs de l'instrumentation (non atomiques) ne se partagent entre threads.
+ */
+#if AVLTREE_STATS
+#define AVLSETOPS_SHAREABLE(ops)    (!(ops)->pool && !(ops)->stats)
+#else
+#define AVLSETOPS_SHAREABLE(ops)    (!(ops)->pool)
+#endif
+
+/*
+ * Accroche 'left' et 'right' sous 'node', met a jour le noeud et le reequilibre.
+ * Toutes les jointures passent par 'ops' (optionnel) pour maintenir son augmentation.
+ */
+static AVLTree AVLtree_link(AVLTree left, AVLTree node, AVLTree right, const AVLOps *ops) {
+    node->left = left;
+    node->right = right;
+    AVLtree_updateOps(node, ops);
+    return AVLtree_rebalanceOps(node, ops);
+}
+
+/*
+ * Jointure lorsque 'left' est plus haut que 'right' de plus d'un niveau : on descend la
+ * branche droite de 'left' jusqu'a un sous-arbre de hauteur compatible avec 'right', on y
+ * accroche 'node', puis on reequilibre en remontant (une rotation par niveau au plus).
+ */
+static AVLTree AVLtree_joinRight(AVLTree left, AVLTree node, AVLTree right, const AVLOps *ops) {
+    if (AVLtree_getHeight(left->right) <= AVLtree_getHeight(right) + 1)
+        left->right = AVLtree_link(left->right, node, right, ops);
+    else
+        left->right = AVLtree_joinRight(left->right, node, right, ops);
+
+    AVLtree_updateOps(left, ops);
+    return AVLtree_rebalanceOps(left, ops);
+}
+
+/*
+ * Symetrique de #AVLtree_joinRight() lorsque 'right' est le plus haut.
+ */
+static AVLTree AVLtree_joinLeft(AVLTree left, AVLTree node, AVLTree right, const AVLOps *ops) {
+    if (AVLtree_getHeight(right->left) <= AVLtree_getHeight(left) + 1)
+        right->left = AVLtree_link(left, node, right->left, ops);
+    else
+        right->left = AVLtree_joinLeft(left, node, right->left, ops);
+
+    AVLtree_updateOps(right, ops);
+    return AVLtree_rebalanceOps(right, ops);
+}
+
+/*
+ * Jointure de deux AVL : toutes les donnees de 'left' doivent etre plus petites que celle
+ * de 'node', elle-meme plus petite que toutes celles de 'right'.
+ * Cout en O(|hauteur(left) - hauteur(right)| + 1). Renvoie la racine du resultat.
+ */
+AVLTree AVLtree_join(AVLTree left, AVLTree node, AVLTree right) {
+    return AVLtree_joinOps(left, node, right, NULL);
+}
+
+/*
+ * Identique a #AVLtree_join(), en maintenant l'augmentation de 'ops' (et en comptant ses
+ * rotations) sur les noeuds modifies.
+ */
+AVLTree AVLtree_joinOps(AVLTree left, AVLTree node, AVLTree right, const AVLOps *ops) {
+    if (AVLtree_getHeight(left) > AVLtree_getHeight(right) + 1)
+        return AVLtree_joinRight(left, node, right, ops);
+    if (AVLtree_getHeight(right) > AVLtree_getHeight(left) + 1)
+        return AVLtree_joinLeft(left, node, right, ops);
+    return AVLtree_link(left, node, right, ops);
+}
+
+/*
+ * Detache le plus grand noeud de 'tree' dans '*last' et renvoie le reste de l'arbre.
+ */
+static AVLTree AVLtree_splitLast(AVLTree tree, AVLTree *last, const AVLOps *ops) {
+    AVLTree rest;
+
+    if (!tree->right) {
+        *last = tree;
+        rest = tree->left;
+        tree->left = NULL;
+        return rest;
+    }
+    rest = AVLtree_splitLast(tree->right, last, ops);
+    return AVLtree_joinOps(tree->left, tree, rest, ops);
+}
+
+/*
+ * Jointure sans noeud pivot : toutes les donnees de 'left' doivent etre plus petites que
+ * celles de 'right'. Le maximum de 'left' sert de pivot.
+ */
+AVLTree AVLtree_join2(AVLTree left, AVLTree right) {
+    return AVLtree_join2Ops(left, right, NULL);
+}
+
+/*
+ * Identique a #AVLtree_join2(), en maintenant l'augmentation de 'ops'.
+ */
+AVLTree AVLtree_join2Ops(AVLTree left, AVLTree right, const AVLOps *ops) {
+    AVLTree last;
+
+    if (!left)
+        return right;
+    if (!right)
+        return left;
+    left = AVLtree_splitLast(left, &last, ops);
+    return AVLtree_joinOps(left, last, right, ops);
+}
+
+//----------------------------------------
+/*
+ * Coupe 'tree' selon 'data' : '*left' recoit les donnees plus petites, '*right' les plus
+ * grandes. Le noeud egal a 'data', s'il existe, est detache et renvoye ; sinon NULL.
+ * L'arbre d'origine est consomme. Cout en O(log n). Les deux moities et le noeud
+ * renvoye ont une augmentation a jour.
+ */
+AVLTree AVLtree_split(AVLTree tree, const AVLOps *ops, const void *data, AVLTree *left, AVLTree *right) {
+    AVLTree found, subLeft, subRight, node;
+    int     res;
+
+    if (!tree) {
+        *left = NULL;
+        *right = NULL;
+        return NULL;
+    }
+
+    node = tree;
+    subLeft = node->left;
+    subRight = node->right;
+    node->left = NULL;
+    node->right = NULL;
+
+    if ((res = AVLtree_compare(ops, data, node->data)) == 0) {
+        *left = subLeft;
+        *right = subRight;
+        AVLtree_updateOps(node, ops);
+        return node;
+    }
+
+    if (res < 0) {
+        found = AVLtree_split(subLeft, ops, data, left, &subLeft);
+        *right = AVLtree_joinOps(subLeft, node, subRight, ops);
+    } else {
+        found = AVLtree_split(subRight, ops, data, &subRight, right);
+        *left = AVLtree_joinOps(subLeft, node, subRight, ops);
+    }
+    return found;
+}
+
+/*
+ * Extrait de 'tree' les donnees de l'intervalle [low, high) et les renvoie sous forme d'AVL.
+ * '*below' recoit les donnees < low et '*above' celles >= high. Cout en O(log n).
+ */
+AVLTree AVLtree_splitRange(AVLTree tree, const AVLOps *ops, const void *low, const void *high, AVLTree *below, AVLTree *above) {
+    AVLTree found, middle, rest;
+
+    found = AVLtree_split(tree, ops, low, below, &rest);
+    if (found)
+        rest = AVLtree_joinOps(NULL, found, rest, ops);
+
+    found = AVLtree_split(rest, ops, high, &middle, above);
+    if (found)
+        *above = AVLtree_joinOps(NULL, found, *above, ops);
+    return middle;
+}
+
+//----------------------------------------
+/*
+ * Operations ensemblistes par 'diviser pour regner' : la racine du premier arbre coupe le
+ * second, les deux moities sont traitees independamment puis recollees par jointure.
+ * Les deux sous-problemes etant disjoints, l'un d'eux peut etre confie a un autre thread.
+ */
+typedef enum AVLSetKind {
+    AVLSET_UNION,
+    AVLSET_INTERSECTION,
+    AVLSET_DIFFERENCE
+} AVLSetKind;
+
+typedef struct AVLSetArgs {
+    AVLSetKind      kind;
+    AVLTree         tree1;
+    AVLTree         tree2;
+    const AVLOps    *ops;
+    AVLWorkers      *workers;
+    AVLTree         result;
+} AVLSetArgs;
+
+static AVLTree AVLtree_setOperation(AVLSetKind kind, AVLTree tree1, AVLTree tree2, const AVLOps *ops, AVLWorkers *workers);
+
+static void AVLtree_setTask(void *arg) {
+    AVLSetArgs *args = (AVLSetArgs *) arg;
+
+    args->result = AVLtree_setOperation(args->kind, args->tree1, args->tree2, args->ops, args->workers);
+}
+
+/*
+ * Traite les cas ou l'un des deux arbres est vide.
+ */
+static AVLTree AVLtree_setTrivial(AVLSetKind kind, AVLTree tree1, AVLTree tree2, const AVLOps *ops) {
+    switch (kind) {
+        case AVLSET_UNION:
+            return (tree1) ? tree1 : tree2;
+        case AVLSET_INTERSECTION:
+            AVLtree_deleteSubtree(&tree1, ops);
+            AVLtree_deleteSubtree(&tree2, ops);
+            return NULL;
+        default:
+            AVLtree_deleteSubtree(&tree2, ops);
+            return tree1;
+    }
+}
+
+static AVLTree AVLtree_setOperation(AVLSetKind kind, AVLTree tree1, AVLTree tree2, const AVLOps *ops, AVLWorkers *workers) {
+    AVLSetArgs  leftArgs;
+    AVLTask     task;
+    AVLTree     node, found, left2, right2, left, right;
+    bool        keep;
+
+    if (!tree1 || !tree2)
+        return AVLtree_setTrivial(kind, tree1, tree2, ops);
+
+    node = tree1;
+    found = AVLtree_split(tree2, ops, node->data, &left2, &right2);
+
+    leftArgs = (AVLSetArgs) { kind, node->left, left2, ops, workers, NULL };
+    if (workers && AVLtree_getHeight(node) > AVLSETOPS_GRAIN_HEIGHT) {
+        AVLworkers_fork(workers, &task, AVLtree_setTask, &leftArgs);
+        right = AVLtree_setOperation(kind, node->right, right2, ops, workers);
+        AVLworkers_join(workers, &task);
+    } else {
+        AVLtree_setTask(&leftArgs);
+        right = AVLtree_setOperation(kind, node->right, right2, ops, workers);
+    }
+    left = leftArgs.result;
+
+    if (found)
+        AVLtree_freeNode(ops, found);
+
+    keep = (kind == AVLSET_UNION) || ((kind == AVLSET_INTERSECTION) == (found != NULL));
+    if (keep)
+        return AVLtree_joinOps(left, node, right, ops);
+    AVLtree_freeNode(ops, node);
+    return AVLtree_join2Ops(left, right, ops);
+}
+
+/*
+ * Lance une operation ensembliste, sur 'nbThreads' threads si demande.
+ * Les allocateurs par pool et les compteurs n'etant pas partages entre threads, une
+ * operation sur des arbres alloues dans un pool, ou instrumentee, reste sequentielle.
+ */
+static AVLTree AVLtree_setRun(AVLSetKind kind, AVLTree tree1, AVLTree tree2, const AVLOps *ops, unsigned int nbThreads) {
+    AVLWorkers  *workers;
+    AVLTree     result;
+
+    workers = NULL;
+    if (nbThreads > 1 && AVLSETOPS_SHAREABLE(ops))
+        workers = AVLworkers_create(nbThreads - 1);
+
+    result = AVLtree_setOperation(kind, tree1, tree2, ops, workers);
+    AVLworkers_destroy(workers);
+    return result;
+}
+
+/*
+ * Union de deux arbres. Les deux arbres sont consommes : leurs noeuds sont reutilises dans
+ * le resultat et, pour les donnees presentes des deux cotes, le noeud de 'tree2' est libere.
+ * Cout en O(m log(n/m + 1)) pour m <= n, au lieu de m insertions.
+ */
+AVLTree AVLtree_union(AVLTree tree1, AVLTree tree2, const AVLOps *ops, unsigned int nbThreads) {
+    return AVLtree_setRun(AVLSET_UNION, tree1, tree2, ops, nbThreads);
+}
+
+/*
+ * Intersection de deux arbres (noeuds de 'tree1' gardes). Les deux arbres sont consommes,
+ * les noeuds absents du resultat sont liberes.
+ */
+AVLTree AVLtree_intersection(AVLTree tree1, AVLTree tree2, const AVLOps *ops, unsigned int nbThreads) {
+    return AVLtree_setRun(AVLSET_INTERSECTION, tree1, tree2, ops, nbThreads);
+}
+
+/*
+ * Difference 'tree1' prive de 'tree2'. Les deux arbres sont consommes, les noeuds absents
+ * du resultat sont liberes.
+ */
+AVLTree AVLtree_difference(AVLTree tree1, AVLTree tree2, const AVLOps *ops, unsigned int nbThreads) {
+    return AVLtree_setRun(AVLSET_DIFFERENCE, tree1, tree2, ops, nbThreads);
+}
+
+//----------------------------------------
+/*
+ * Insertion et suppression par lots : le lot trie est coupe par la racine (recherche
+ * dichotomique), chaque moitie descend dans le sous-arbre correspondant et les deux
+ * resultats sont recolles sous la racine par jointure. Chaque noeud touche n'est visite et
+ * reequilibre qu'une fois ; un morceau de lot qui arrive sur un sous-arbre vide y est
+ * construit directement (#AVLtree_buildFromSortedOps()).
+ */
+typedef struct AVLBatchArgs {
+    bool            insert;
+    AVLTree         tree;
+    const char      *array;
+    size_t          count;
+    size_t          elemSize;
+    const AVLOps    *ops;
+    AVLWorkers      *workers;
+    AVLTree         result;
+} AVLBatchArgs;
+
+static AVLTree AVLtree_batchOperation(bool insert, AVLTree tree, const char *array, size_t count, size_t elemSize,
+                                      const AVLOps *ops, AVLWorkers *workers);
+
+static void AVLtree_batchTask(void *arg) {
+    AVLBatchArgs *args = (AVLBatchArgs *) arg;
+
+    args->result = AVLtree_batchOperation(args->insert, args->tree, args->array, args->count, args->elemSize,
+                                          args->ops, args->workers);
+}
+
+static AVLTree AVLtree_batchOperation(bool insert, AVLTree tree, const char *array, size_t count, size_t elemSize,
+                                      const AVLOps *ops, AVLWorkers *workers) {
+    AVLBatchArgs    leftArgs;
+    AVLTask         task;
+    AVLTree         node, right;
+    size_t          low, high, middle, skip;
+    bool            found;
+
+    if (!count)
+        return tree;
+    if (!tree)
+        return (insert) ? AVLtree_buildFromSortedOps(ops, array, count, elemSize) : NULL;
+
+    //premier element du lot >= la donnee de la racine
+    node = tree;
+    low = 0;
+    high = count;
+    while (low < high) {
+        middle = low + (high - low) / 2;
+        if (AVLtree_compare(ops, array + middle * elemSize, node->data) < 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    found = low < count && AVLtree_compare(ops, array + low * elemSize, node->data) == 0;
+    skip = low + found;
+
+    leftArgs = (AVLBatchArgs) { insert, node->left, array, low, elemSize, ops, workers, NULL };
+    if (workers && low && count > skip && AVLtree_getHeight(node) > AVLSETOPS_GRAIN_HEIGHT) {
+        AVLworkers_fork(workers, &task, AVLtree_batchTask, &leftArgs);
+        right = AVLtree_batchOperation(insert, node->right, array + skip * elemSize, count - skip, elemSize, ops, workers);
+        AVLworkers_join(workers, &task);
+    } else {
+        AVLtree_batchTask(&leftArgs);
+        right = AVLtree_batchOperation(insert, node->right, array + skip * elemSize, count - skip, elemSize, ops, workers);
+    }
+
+    if (!insert && found) {
+        AVLtree_freeNode(ops, node);
+        return AVLtree_join2Ops(leftArgs.result, right, ops);
+    }
+    return AVLtree_joinOps(leftArgs.result, node, right, ops);
+}
+
+/*
+ * Commun a l'insertion et a la suppression : trie le lot et lance la descente, sur
+ * 'nbThreads' threads si demande (jamais avec un pool ni des compteurs, comme les
+ * operations ensemblistes).
+ * Le tri demande un comparateur a trois issues ; avec le seul predicat 'cmp', les elements
+ * sont appliques un par un.
+ */
+static AVLTree AVLtree_batchRun(bool insert, AVLTree tree, const AVLOps *ops, void *array, size_t count,
+                                size_t elemSize, unsigned int nbThreads) {
+    AVLWorkers  *workers;
+    size_t      index;
+
+    if (!ops->cmp3) {
+        for (index = 0; index < count; index++) {
+            if (insert)
+                tree = AVLtree_insertOps(tree, ops, (char *) array + index * elemSize, elemSize);
+            else
+                tree = AVLtree_deleteOps(tree, ops, (char *) array + index * elemSize);
+        }
+        return tree;
+    }
+
+    count = AVLtree_sortUnique(array, count, elemSize, ops->cmp3);
+    workers = NULL;
+    if (nbThreads > 1 && AVLSETOPS_SHAREABLE(ops))
+        workers = AVLworkers_create(nbThreads - 1);
+
+    tree = AVLtree_batchOperation(insert, tree, (const char *) array, count, elemSize, ops, workers);
+    AVLworkers_destroy(workers);
+    return tree;
+}
+
+/*
+ * Insere les 'count' elements de 'array' (de 'elemSize' octets) absents de l'arbre ; les
+ * donnees deja presentes ne sont pas remplacees. 'array' est trie sur place et ses doublons
+ * sont retires. Cout en O(m log(n/m + 1)) pour un lot de m elements, au lieu de m
+ * descentes. Renvoie la nouvelle racine.
+ */
+AVLTree AVLtree_insertBatch(AVLTree tree, const AVLOps *ops, void *array, size_t count, size_t elemSize,
+                            unsigned int nbThreads) {
+    return AVLtree_batchRun(true, tree, ops, array, count, elemSize, nbThreads);
+}
+
+/*
+ * Supprime de l'arbre les donnees egales aux elements de 'array', trie sur place. Les
+ * noeuds retires sont liberes selon 'ops'. Renvoie la nouvelle racine.
+ */
+AVLTree AVLtree_deleteBatch(AVLTree tree, const AVLOps *ops, void *array, size_t count, size_t elemSize,
+                            unsigned int nbThreads) {
+    return AVLtree_batchRun(false, tree, ops, array, count, elemSize, nbThreads);
+}
@@ -0,0 +1,38 @@
+#ifndef _AVLSETOPS_H_
+#define _AVLSETOPS_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "avltree.h"
+
+
+/*
+ * Hauteur a partir de laquelle les operations ensemblistes confient un des deux
+ * sous-problemes a un autre thread (2^12 noeuds environ par tache au minimum).
+ */
+#define AVLSETOPS_GRAIN_HEIGHT  12
+
+/*--------------------------------------------------------------------*/
+AVLTree AVLtree_join(AVLTree left, AVLTree node, AVLTree right);
+AVLTree AVLtree_joinOps(AVLTree left, AVLTree node, AVLTree right, const AVLOps *ops);
+AVLTree AVLtree_join2(AVLTree left, AVLTree right);
+AVLTree AVLtree_join2Ops(AVLTree left, AVLTree right, const AVLOps *ops);
+
+//----------------------------------------
+AVLTree AVLtree_split(AVLTree tree, const AVLOps *ops, const void *data, AVLTree *left, AVLTree *right);
+AVLTree AVLtree_splitRange(AVLTree tree, const AVLOps *ops, const void *low, const void *high, AVLTree *below, AVLTree *above);
+
+//----------------------------------------
+AVLTree AVLtree_union(AVLTree tree1, AVLTree tree2, const AVLOps *ops, unsigned int nbThreads);
+AVLTree AVLtree_intersection(AVLTree tree1, AVLTree tree2, const AVLOps *ops, unsigned int nbThreads);
+AVLTree AVLtree_difference(AVLTree tree1, AVLTree tree2, const AVLOps *ops, unsigned int nbThreads);
+
+//----------------------------------------
+AVLTree AVLtree_insertBatch(AVLTree tree, const AVLOps *ops, void *array, size_t count, size_t elemSize,
+                            unsigned int nbThreads);
+AVLTree AVLtree_deleteBatch(AVLTree tree, const AVLOps *ops, void *array, size_t count, size_t elemSize,
+                            unsigned int nbThreads);
+/*--------------------------------------------------------------------*/
+
+#endif
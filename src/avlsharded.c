@@ -0,0 +1,570 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <sched.h>
+
+#include "avlsharded.h"
+#include "avlsetops.h"
+#include "avlcursor.h"
+
+
+/*
+ * Parcours d'un shard pour #AVLsharded_range() : retient que 'func' a demande l'arret,
+ * pour ne pas continuer dans les shards suivants.
+ */
+typedef struct {
+    bool    (*func)(void *, void *);
+    void    *extra_data;
+    bool    stopped;
+} AVLShardVisit;
+
+/*
+ * Compteur de lecteurs du thread courant : chaque thread recoit un numero a son premier
+ * acces et compte ses lectures du decoupage dans le shard de meme rang (modulo), pour que
+ * les threads ne se disputent pas une meme ligne de cache. 0 : pas encore de numero.
+ */
+static atomic_uint                  AVLsharded_nextReader;
+static _Thread_local unsigned int   AVLsharded_reader;
+
+//----------------------------------------
+static AVLOps AVLsharded_ops(const AVLSharded *set, AVLShard *shard) {
+    return (AVLOps) { .cmp3 = set->cmp3, .pool = &shard->pool };
+}
+
+static char *AVLsharded_bound(const AVLSharded *set, const AVLShardLayout *layout, size_t index) {
+    return (char *) layout->bounds + index * set->elemSize;
+}
+
+/*
+ * Indice du shard de 'data'. Par intervalles, c'est le nombre de bornes inferieures ou
+ * egales a 'data'. Par hachage, le hache est d'abord melange (multiplication de Fibonacci)
+ * pour qu'une fonction de hachage faible ne remplisse pas quelques shards seulement.
+ */
+static unsigned int AVLsharded_locate(const AVLSharded *set, const AVLShardLayout *layout, const void *data) {
+    size_t  low, high, middle;
+
+    if (set->hash)
+        return (unsigned int) ((((uint64_t) set->hash(data) * UINT64_C(0x9E3779B97F4A7C15)) >> 32) % set->nbShards);
+
+    low = 0;
+    high = layout->nbFinite;
+    while (low < high) {
+        middle = low + (high - low) / 2;
+        if (set->cmp3(data, AVLsharded_bound(set, layout, middle)) >= 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return (unsigned int) low;
+}
+
+static atomic_uint *AVLsharded_readers(AVLSharded *set) {
+    if (!AVLsharded_reader)
+        AVLsharded_reader = atomic_fetch_add(&AVLsharded_nextReader, 1) % UINT_MAX + 1;
+    return &set->shards[AVLsharded_reader % set->nbShards].readers;
+}
+
+/*
+ * Debut de lecture du decoupage : note la version courante ('nbRebalances', augmente a
+ * chaque publication) puis renvoie le decoupage, qui ne sera pas libere avant
+ * #AVLsharded_readEnd(). Le lecteur est compte avant de charger le pointeur : un
+ * reequilibrage qui a deja publie le decoupage suivant le verra forcement (voir
+ * #AVLsharded_synchronize()). Par hachage, il n'y a pas de decoupage.
+ */
+static AVLShardLayout *AVLsharded_readBegin(AVLSharded *set, size_t *version) {
+    *version = atomic_load(&set->nbRebalances);
+    if (set->hash)
+        return NULL;
+    atomic_fetch_add(AVLsharded_readers(set), 1);
+    return atomic_load(&set->layout);
+}
+
+static void AVLsharded_readEnd(AVLSharded *set) {
+    if (!set->hash)
+        atomic_fetch_sub(AVLsharded_readers(set), 1);
+}
+
+/*
+ * Attend que chaque compteur de lecteurs ait ete vu a zero : tout thread qui lisait un
+ * decoupage retire avant l'appel a alors fini de s'en servir, et ce decoupage peut etre
+ * libere. Un lecteur ne prend aucun verrou avant #AVLsharded_readEnd(), l'attente est
+ * donc courte.
+ */
+static void AVLsharded_synchronize(AVLSharded *set) {
+    unsigned int index;
+
+    for (index = 0; index < set->nbShards; index++)
+        while (atomic_load(&set->shards[index].readers))
+            sched_yield();
+}
+
+/*
+ * Verrouille le shard de 'data' et renvoie son indice. Si un reequilibrage a publie un
+ * nouveau decoupage entre la localisation et la prise du verrou, la donnee a pu changer
+ * de shard : on relache et on recommence. La version est comparee plutot que l'adresse
+ * du decoupage, qui peut avoir ete liberee puis reattribuee entre temps.
+ */
+static unsigned int AVLsharded_lock(AVLSharded *set, const void *data) {
+    AVLShardLayout  *layout;
+    unsigned int    index;
+    size_t          version;
+
+    for (;;) {
+        layout = AVLsharded_readBegin(set, &version);
+        index = AVLsharded_locate(set, layout, data);
+        AVLsharded_readEnd(set);
+        pthread_mutex_lock(&set->shards[index].lock);
+        if (atomic_load(&set->nbRebalances) == version)
+            return index;
+        pthread_mutex_unlock(&set->shards[index].lock);
+    }
+}
+
+//----------------------------------------
+/*
+ * Partie commune des deux initialisations ; le decoupage reste a fournir.
+ */
+static bool AVLsharded_setup(AVLSharded *set, unsigned int nbShards, size_t elemSize,
+                             int (*cmp3)(const void *, const void *), size_t (*hash)(const void *)) {
+    unsigned int index;
+
+    if (!set || !cmp3 || nbShards == 0)
+        return false;
+    if (!(set->shards = (AVLShard *) aligned_alloc(64, sizeof(AVLShard) * nbShards)))
+        return false;
+
+    for (index = 0; index < nbShards; index++) {
+        pthread_mutex_init(&set->shards[index].lock, NULL);
+        set->shards[index].root = NULL;
+        AVLpool_init(&set->shards[index].pool, elemSize, AVLSHARDED_SLAB);
+        atomic_init(&set->shards[index].count, 0);
+        atomic_init(&set->shards[index].readers, 0);
+    }
+    set->nbShards = nbShards;
+    set->elemSize = elemSize;
+    set->cmp3 = cmp3;
+    set->hash = hash;
+    atomic_init(&set->layout, NULL);
+    pthread_mutex_init(&set->rebalanceLock, NULL);
+    atomic_init(&set->nbRebalances, 0);
+    return true;
+}
+
+/*
+ * Initialise un ensemble vide reparti par intervalles sur 'nbShards' shards.
+ * 'bounds' donne les 'nbBounds' premieres bornes (au plus nbShards - 1, strictement
+ * croissantes) : le shard i recoit les donnees de [bounds[i - 1], bounds[i]). Les bornes
+ * absentes valent +infini ; avec 'bounds' a NULL tout commence dans le shard 0 et le
+ * reequilibrage etale les donnees au fil des ajouts.
+ * Renvoie false si les bornes sont invalides ou en cas d'echec d'allocation.
+ */
+bool    AVLsharded_init(AVLSharded *set, unsigned int nbShards, size_t elemSize, int (*cmp3)(const void *, const void *),
+                        const void *bounds, size_t nbBounds) {
+    AVLShardLayout  *layout;
+    size_t          index;
+
+    if (!cmp3 || nbShards == 0 || nbBounds > nbShards - 1 || (nbBounds && !bounds))
+        return false;
+    for (index = 1; index < nbBounds; index++)
+        if (cmp3((const char *) bounds + (index - 1) * elemSize, (const char *) bounds + index * elemSize) >= 0)
+            return false;
+
+    if (!(layout = (AVLShardLayout *) malloc(sizeof(AVLShardLayout) + (nbShards - 1) * elemSize)))
+        return false;
+    if (!AVLsharded_setup(set, nbShards, elemSize, cmp3, NULL)) {
+        free(layout);
+        return false;
+    }
+    layout->previous = NULL;
+    layout->nbFinite = nbBounds;
+    if (nbBounds)
+        memcpy(layout->bounds, bounds, nbBounds * elemSize);
+    atomic_init(&set->layout, layout);
+    return true;
+}
+
+/*
+ * Initialise un ensemble vide reparti par hachage : la donnee 'data' va dans le shard
+ * donne par 'hash(data)'. Deux donnees egales pour 'cmp3' doivent avoir le meme hache.
+ */
+bool    AVLsharded_initHash(AVLSharded *set, unsigned int nbShards, size_t elemSize,
+                            int (*cmp3)(const void *, const void *), size_t (*hash)(const void *)) {
+    if (!hash)
+        return false;
+    return AVLsharded_setup(set, nbShards, elemSize, cmp3, hash);
+}
+
+/*
+ * Libere les shards et le decoupage courant (les precedents sont liberes a la fin de
+ * chaque reequilibrage). Plus aucun thread ne doit utiliser l'ensemble.
+ */
+void    AVLsharded_destroy(AVLSharded *set) {
+    unsigned int index;
+
+    for (index = 0; index < set->nbShards; index++) {
+        AVLpool_release(&set->shards[index].pool);
+        pthread_mutex_destroy(&set->shards[index].lock);
+    }
+    free(atomic_load(&set->layout));
+    pthread_mutex_destroy(&set->rebalanceLock);
+    free(set->shards);
+    set->shards = NULL;
+    set->nbShards = 0;
+    atomic_store(&set->layout, NULL);
+}
+
+//----------------------------------------
+/*
+ * Renvoie le nombre d'elements. Pendant des ecritures concurrentes, la valeur n'est
+ * qu'une estimation : les shards sont lus l'un apres l'autre, sans verrou.
+ */
+size_t  AVLsharded_getSize(AVLSharded *set) {
+    size_t          size;
+    unsigned int    index;
+
+    size = 0;
+    for (index = 0; index < set->nbShards; index++)
+        size += atomic_load_explicit(&set->shards[index].count, memory_order_relaxed);
+    return size;
+}
+
+size_t  AVLsharded_getShardSize(AVLSharded *set, unsigned int index) {
+    if (index >= set->nbShards)
+        return 0;
+    return atomic_load_explicit(&set->shards[index].count, memory_order_relaxed);
+}
+
+/*
+ * Renvoie le nombre de reequilibrages effectues depuis l'initialisation.
+ */
+size_t  AVLsharded_getRebalances(AVLSharded *set) {
+    return atomic_load(&set->nbRebalances);
+}
+
+//----------------------------------------
+/*
+ * Deplace les 'count' plus grandes donnees du shard 'from' vers le shard suivant ('to'
+ * vaut from + 1), ou ses 'count' plus petites vers le precedent, puis publie le nouveau
+ * decoupage ; l'ancien est ajoute a la liste '*retired', a liberer apres
+ * #AVLsharded_synchronize(). Les deux shards sont verrouilles.
+ * Le shard est coupe en O(log n) ; les donnees qui partent sont recopiees dans le pool
+ * du shard d'arrivee, un noeud ne quittant jamais le pool qui l'a alloue.
+ */
+static void AVLsharded_move(AVLSharded *set, unsigned int from, unsigned int to, size_t count,
+                            AVLShardLayout **retired) {
+    AVLShard        *source = &set->shards[from], *target = &set->shards[to];
+    AVLOps          sourceOps = AVLsharded_ops(set, source);
+    AVLShardLayout  *layout, *next;
+    AVLCursor       cursor;
+    AVLTree         found, below, above, moved, built;
+    char            *array, *bound;
+    size_t          index;
+
+    layout = atomic_load(&set->layout);
+    next = (AVLShardLayout *) malloc(sizeof(AVLShardLayout) + (set->nbShards - 1) * set->elemSize);
+    array = (char *) malloc(count * set->elemSize);
+    if (count == 0 || !next || !array) {
+        free(next);
+        free(array);
+        return;
+    }
+
+    //copie des donnees qui partent ; le curseur finit sur la nouvelle borne
+    AVLcursor_init(&cursor, source->root);
+    if (to < from) {
+        AVLcursor_first(&cursor);
+        for (index = 0; index < count; index++, AVLcursor_next(&cursor))
+            memcpy(array + index * set->elemSize, AVLcursor_getData(&cursor), set->elemSize);
+    } else {
+        AVLcursor_last(&cursor);
+        for (index = count; index > 0; index--) {
+            memcpy(array + (index - 1) * set->elemSize, AVLcursor_getData(&cursor), set->elemSize);
+            if (index > 1)
+                AVLcursor_prev(&cursor);
+        }
+    }
+
+    //la borne entre les deux shards devient la plus petite donnee du cote droit
+    index = (to < from) ? to : from;
+    memcpy(next->bounds, layout->bounds, layout->nbFinite * set->elemSize);
+    next->nbFinite = (layout->nbFinite > index) ? layout->nbFinite : index + 1;
+    bound = AVLsharded_bound(set, next, index);
+    memcpy(bound, AVLcursor_getData(&cursor), set->elemSize);
+
+    found = AVLtree_split(source->root, &sourceOps, bound, &below, &above);
+    above = AVLtree_join(NULL, found, above);
+    moved = (to < from) ? below : above;
+    source->root = (to < from) ? above : below;
+
+    if (!(built = AVLtree_buildFromSortedPool(&target->pool, array, count, set->elemSize))) {
+        source->root = (to < from) ? AVLtree_join2(moved, source->root) : AVLtree_join2(source->root, moved);
+        free(next);
+        free(array);
+        return;
+    }
+    target->root = (to < from) ? AVLtree_join2(target->root, built) : AVLtree_join2(built, target->root);
+    AVLtree_deleteSubtree(&moved, &sourceOps);
+    free(array);
+
+    atomic_fetch_sub_explicit(&source->count, count, memory_order_relaxed);
+    atomic_fetch_add_explicit(&target->count, count, memory_order_relaxed);
+    next->previous = NULL;
+    atomic_store(&set->layout, next);
+    atomic_fetch_add(&set->nbRebalances, 1);
+    layout->previous = *retired;
+    *retired = layout;
+}
+
+/*
+ * Si le shard 'index' depasse deux fois la taille moyenne, ramene-le a la moyenne en
+ * cedant son surplus a son plus petit voisin, qui cede a son tour le sien au suivant dans
+ * la meme direction, jusqu'a un shard qui peut l'absorber : seul le shard qui recoit les
+ * ajouts declenche le controle, le surplus doit donc se propager de proche en proche.
+ * Un seul reequilibrage a la fois : si un autre est en cours, on laisse faire (le
+ * controle sera refait apres les prochains ajouts). Les decoupages remplaces sont
+ * liberes a la fin, une fois les verrous des shards rendus.
+ */
+static void AVLsharded_balance(AVLSharded *set, unsigned int index) {
+    AVLShardLayout  *retired, *previous;
+    unsigned int    neighbor, first, second;
+    size_t          mean, size, left, right;
+    int             direction;
+
+    if (set->hash || set->nbShards < 2)
+        return;
+    mean = AVLsharded_getSize(set) / set->nbShards;
+    if (AVLsharded_getShardSize(set, index) <= 2 * mean + AVLSHARDED_REBALANCE_MIN)
+        return;
+    if (pthread_mutex_trylock(&set->rebalanceLock) != 0)
+        return;
+
+    left = (index > 0) ? AVLsharded_getShardSize(set, index - 1) : SIZE_MAX;
+    right = (index + 1 < set->nbShards) ? AVLsharded_getShardSize(set, index + 1) : SIZE_MAX;
+    direction = (left <= right) ? -1 : 1;
+    retired = NULL;
+    while ((direction < 0) ? index > 0 : index + 1 < set->nbShards) {
+        neighbor = index + direction;
+
+        //verrous pris dans l'ordre des indices, comme les parcours
+        first = (index < neighbor) ? index : neighbor;
+        second = (index < neighbor) ? neighbor : index;
+        pthread_mutex_lock(&set->shards[first].lock);
+        pthread_mutex_lock(&set->shards[second].lock);
+        if ((size = AVLsharded_getShardSize(set, index)) > mean)
+            AVLsharded_move(set, index, neighbor, size - mean, &retired);
+        pthread_mutex_unlock(&set->shards[second].lock);
+        pthread_mutex_unlock(&set->shards[first].lock);
+
+        index = neighbor;
+        if (AVLsharded_getShardSize(set, index) <= mean + AVLSHARDED_REBALANCE_MIN)
+            break;
+    }
+
+    if (retired)
+        AVLsharded_synchronize(set);
+    for (; retired; retired = previous) {
+        previous = retired->previous;
+        free(retired);
+    }
+    pthread_mutex_unlock(&set->rebalanceLock);
+}
+
+//----------------------------------------
+/*
+ * Cherche 'data' ; si elle existe et que 'result' est non nul, la donnee stockee y est
+ * copiee (le noeud lui-meme peut etre libere des que le verrou est rendu).
+ */
+bool    AVLsharded_search(AVLSharded *set, const void *data, void *result) {
+    AVLShard        *shard;
+    AVLOps          ops;
+    AVLTree         node;
+    unsigned int    index;
+
+    index = AVLsharded_lock(set, data);
+    shard = &set->shards[index];
+    ops = AVLsharded_ops(set, shard);
+    if ((node = AVLtree_searchOps(shard->root, &ops, data)) && result)
+        memcpy(result, node->data, set->elemSize);
+    pthread_mutex_unlock(&shard->lock);
+    return node != NULL;
+}
+
+/*
+ * Ajoute 'data' s'il n'existe pas deja. Renvoie false si la donnee existe deja ou en cas
+ * d'echec d'allocation.
+ */
+bool    AVLsharded_insert(AVLSharded *set, const void *data) {
+    AVLShard        *shard;
+    AVLOps          ops;
+    AVLPath         path;
+    AVLTree         node;
+    unsigned int    index;
+    size_t          count;
+
+    index = AVLsharded_lock(set, data);
+    shard = &set->shards[index];
+    ops = AVLsharded_ops(set, shard);
+    if (AVLtree_pathFind(&shard->root, &ops, data, &path)
+            || !(node = AVLtree_createPool(&shard->pool, data, set->elemSize))) {
+        pthread_mutex_unlock(&shard->lock);
+        return false;
+    }
+    AVLtree_pathInsert(&path, &ops, node);
+    count = atomic_fetch_add_explicit(&shard->count, 1, memory_order_relaxed) + 1;
+    pthread_mutex_unlock(&shard->lock);
+
+    if (count % AVLSHARDED_CHECK_PERIOD == 0)
+        AVLsharded_balance(set, index);
+    return true;
+}
+
+/*
+ * Supprime 'data'. Renvoie false si elle n'existe pas.
+ */
+bool    AVLsharded_delete(AVLSharded *set, const void *data) {
+    AVLShard        *shard;
+    AVLOps          ops;
+    AVLPath         path;
+    unsigned int    index;
+    bool            found;
+
+    index = AVLsharded_lock(set, data);
+    shard = &set->shards[index];
+    ops = AVLsharded_ops(set, shard);
+    if ((found = AVLtree_pathFind(&shard->root, &ops, data, &path) != NULL)) {
+        AVLtree_freeNode(&ops, AVLtree_pathRemove(&path, &ops));
+        atomic_fetch_sub_explicit(&shard->count, 1, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&shard->lock);
+    return found;
+}
+
+//----------------------------------------
+static bool AVLsharded_visit(void *data, void *extra_data) {
+    AVLShardVisit *visit = (AVLShardVisit *) extra_data;
+
+    if (visit->func(data, visit->extra_data))
+        return true;
+    visit->stopped = true;
+    return false;
+}
+
+static bool AVLsharded_less(const AVLSharded *set, const AVLCursor *cursors, unsigned int a, unsigned int b) {
+    return set->cmp3(AVLcursor_getData(&cursors[a]), AVLcursor_getData(&cursors[b])) < 0;
+}
+
+/*
+ * Retablit le tas 'heap' (indices de curseurs, le plus petit en tete) a partir de 'pos'.
+ */
+static void AVLsharded_siftDown(const AVLSharded *set, const AVLCursor *cursors, unsigned int *heap,
+                                unsigned int size, unsigned int pos) {
+    unsigned int child, tmp;
+
+    while ((child = 2 * pos + 1) < size) {
+        if (child + 1 < size && AVLsharded_less(set, cursors, heap[child + 1], heap[child]))
+            child++;
+        if (!AVLsharded_less(set, cursors, heap[child], heap[pos]))
+            break;
+        tmp = heap[pos];
+        heap[pos] = heap[child];
+        heap[child] = tmp;
+        pos = child;
+    }
+}
+
+/*
+ * Fusion en k voies pour le mode hachage, ou chaque shard couvre tout l'intervalle : un
+ * curseur par shard, ranges dans un tas selon leur donnee courante. Cout en
+ * O(log(nbShards)) par element visite.
+ */
+static size_t AVLsharded_merge(AVLSharded *set, const void *low, const void *high,
+                               bool (*func)(void *, void *), void *extra_data) {
+    AVLCursor       *cursors;
+    unsigned int    *heap, size, index;
+    size_t          nbVisited;
+    bool            valid;
+
+    cursors = (AVLCursor *) malloc(sizeof(AVLCursor) * set->nbShards);
+    heap = (unsigned int *) malloc(sizeof(unsigned int) * set->nbShards);
+    if (!cursors || !heap) {
+        free(cursors);
+        free(heap);
+        return 0;
+    }
+
+    size = 0;
+    for (index = 0; index < set->nbShards; index++) {
+        AVLcursor_init(&cursors[index], set->shards[index].root);
+        valid = (low) ? AVLcursor_lowerBound(&cursors[index], set->cmp3, low) : AVLcursor_first(&cursors[index]);
+        if (valid && (!high || set->cmp3(AVLcursor_getData(&cursors[index]), high) < 0))
+            heap[size++] = index;
+    }
+    for (index = size / 2; index-- > 0;)
+        AVLsharded_siftDown(set, cursors, heap, size, index);
+
+    nbVisited = 0;
+    while (size > 0) {
+        nbVisited++;
+        if (!func(AVLcursor_getData(&cursors[heap[0]]), extra_data))
+            break;
+        if (!AVLcursor_next(&cursors[heap[0]])
+                || (high && set->cmp3(AVLcursor_getData(&cursors[heap[0]]), high) >= 0))
+            heap[0] = heap[--size];
+        AVLsharded_siftDown(set, cursors, heap, size, 0);
+    }
+    free(cursors);
+    free(heap);
+    return nbVisited;
+}
+
+/*
+ * Parcours de l'intervalle [low, high) dans l'ordre, tant que 'func' renvoie true ('low'
+ * ou 'high' a NULL : intervalle ouvert de ce cote). Renvoie le nombre d'elements passes
+ * a 'func'.
+ * Les shards concernes restent verrouilles pendant tout le parcours, qui voit donc un
+ * etat coherent ; 'func' ne doit pas modifier l'ensemble. Par intervalles, seuls les
+ * shards qui recouvrent [low, high) sont verrouilles et parcourus l'un apres l'autre ;
+ * par hachage, tous les shards sont fusionnes.
+ */
+size_t  AVLsharded_range(AVLSharded *set, const void *low, const void *high,
+                         bool (*func)(void *, void *), void *extra_data) {
+    AVLShardLayout  *layout;
+    AVLShardVisit   visit;
+    unsigned int    first, last, index;
+    size_t          nbVisited, version;
+
+    for (;;) {
+        layout = AVLsharded_readBegin(set, &version);
+        first = (low && !set->hash) ? AVLsharded_locate(set, layout, low) : 0;
+        last = (high && !set->hash) ? AVLsharded_locate(set, layout, high) : set->nbShards - 1;
+        AVLsharded_readEnd(set);
+        for (index = first; index <= last; index++)
+            pthread_mutex_lock(&set->shards[index].lock);
+        if (atomic_load(&set->nbRebalances) == version)
+            break;
+        for (index = first; index <= last; index++)
+            pthread_mutex_unlock(&set->shards[index].lock);
+    }
+
+    if (set->hash) {
+        nbVisited = AVLsharded_merge(set, low, high, func, extra_data);
+    } else {
+        visit = (AVLShardVisit) { func, extra_data, false };
+        nbVisited = 0;
+        for (index = first; index <= last && !visit.stopped; index++)
+            nbVisited += AVLtree_range(set->shards[index].root, set->cmp3, low, high, AVLsharded_visit, &visit);
+    }
+
+    for (index = first; index <= last; index++)
+        pthread_mutex_unlock(&set->shards[index].lock);
+    return nbVisited;
+}
+
+/*
+ * Parcours infixe de tout l'ensemble (voir #AVLsharded_range()).
+ */
+void    AVLsharded_in_order(AVLSharded *set, bool (*func)(void *, void *), void *extra_data) {
+    AVLsharded_range(set, NULL, NULL, func, extra_data);
+}
@@ -0,0 +1,98 @@
+#ifndef _AVLSHARDED_H_
+#define _AVLSHARDED_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "avltree.h"
+#include "avlpool.h"
+
+
+/*
+ * Seuils du reequilibrage par intervalles : un shard cede des donnees a ses voisins quand
+ * il depasse deux fois la taille moyenne plus AVLSHARDED_REBALANCE_MIN elements.
+ * Le controle n'a lieu que tous les AVLSHARDED_CHECK_PERIOD ajouts dans le shard.
+ * Les pools des shards sont decoupes en blocs de AVLSHARDED_SLAB noeuds.
+ */
+#define AVLSHARDED_REBALANCE_MIN        4096
+#define AVLSHARDED_CHECK_PERIOD         1024
+#define AVLSHARDED_SLAB                 1024
+
+/*
+ * Shard : un AVL independant avec son verrou et son allocateur de noeuds. Chaque shard
+ * occupe ses propres lignes de cache. 'count' n'est modifie que verrou tenu mais peut
+ * etre lu sans verrou pour estimer un desequilibre. 'readers' compte les threads en train
+ * de lire le decoupage qui ont recu ce shard comme compteur, quel que soit leur shard
+ * cible.
+ */
+typedef struct AVLShard AVLShard;
+struct          AVLShard {
+        _Alignas(64) pthread_mutex_t lock;
+        AVLTree         root;
+        AVLPool         pool;
+        atomic_size_t   count;
+        atomic_uint     readers;
+};
+
+/*
+ * Decoupage par intervalles : le shard i recoit les donnees de [bounds[i - 1], bounds[i]).
+ * Seules les 'nbFinite' premieres bornes existent, les suivantes valent +infini (les
+ * shards correspondants sont vides). Un decoupage publie n'est plus jamais modifie : un
+ * reequilibrage en publie un nouveau, chaine l'ancien par 'previous' dans sa liste de
+ * decoupages retires et les libere tous a la fin, des qu'aucun thread ne peut plus les
+ * lire.
+ */
+typedef struct AVLShardLayout AVLShardLayout;
+struct          AVLShardLayout {
+        AVLShardLayout  *previous;
+        size_t          nbFinite;
+        char            bounds[];
+};
+
+/*
+ * Ensemble reparti sur 'nbShards' AVL pour que des ecrivains sur des cles differentes ne
+ * se disputent pas le meme verrou.
+ * Les cles sont reparties soit par intervalles (decoupage ajuste automatiquement quand un
+ * shard grossit trop par rapport a ses voisins), soit par hachage ('hash' non nul, sans
+ * reequilibrage). Une operation ponctuelle ne verrouille que le shard de sa cle ; les
+ * parcours verrouillent les shards concernes et fusionnent leurs donnees dans l'ordre.
+ * 'nbRebalances' sert aussi de version du decoupage : il augmente a chaque publication.
+ */
+typedef struct AVLSharded AVLSharded;
+struct          AVLSharded {
+        AVLShard                *shards;
+        unsigned int            nbShards;
+        size_t                  elemSize;
+        int                     (*cmp3)(const void *, const void *);
+        size_t                  (*hash)(const void *);
+        _Atomic(AVLShardLayout *) layout;
+        pthread_mutex_t         rebalanceLock;
+        atomic_size_t           nbRebalances;
+};
+
+/*--------------------------------------------------------------------*/
+bool    AVLsharded_init(AVLSharded *set, unsigned int nbShards, size_t elemSize, int (*cmp3)(const void *, const void *),
+                        const void *bounds, size_t nbBounds);
+bool    AVLsharded_initHash(AVLSharded *set, unsigned int nbShards, size_t elemSize,
+                            int (*cmp3)(const void *, const void *), size_t (*hash)(const void *));
+void    AVLsharded_destroy(AVLSharded *set);
+
+//----------------------------------------
+size_t  AVLsharded_getSize(AVLSharded *set);
+size_t  AVLsharded_getShardSize(AVLSharded *set, unsigned int index);
+size_t  AVLsharded_getRebalances(AVLSharded *set);
+
+//----------------------------------------
+bool    AVLsharded_search(AVLSharded *set, const void *data, void *result);
+bool    AVLsharded_insert(AVLSharded *set, const void *data);
+bool    AVLsharded_delete(AVLSharded *set, const void *data);
+
+//----------------------------------------
+size_t  AVLsharded_range(AVLSharded *set, const void *low, const void *high,
+                         bool (*func)(void *, void *), void *extra_data);
+void    AVLsharded_in_order(AVLSharded *set, bool (*func)(void *, void *), void *extra_data);
+/*--------------------------------------------------------------------*/
+
+#endif
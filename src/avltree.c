@@ -1,10 +1,13 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #include <unistd.h>
 
 #include "avltree.h"
+#include "avlpool.h"
 #include "min-max.h"
 
 
@@ -48,17 +51,141 @@ bool AVLtree_setData(const AVLTree tree, const void *data, size_t size) {
  * lors de l'allocation de memoire pour pouvoir y faire rentrer n'importe quelle valeur.
  */
 AVLTree AVLtree_create(const void *data, size_t size) {
+    return AVLtree_createPool(NULL, data, size);
+}
+
+/*
+ * Identique a #AVLtree_create() mais le noeud est pris dans le pool 'pool' s'il est
+ * non nul (voir avlpool.h). La donnee doit alors tenir dans la taille prevue par le pool.
+ */
+AVLTree AVLtree_createPool(AVLPool *pool, const void *data, size_t size) {
     AVLTree tree;
 
     tree = AVLtree_new();
-    if ((tree = (AVLTree) malloc((sizeof(AVLTree) * 2) + sizeof(int) + size))) {
+    if (pool) {
+        if (size > pool->dataSize)
+            return NULL;
+        tree = AVLpool_alloc(pool);
+    } else {
+        tree = (AVLTree) malloc(AVLtree_nodeSize(size));
+    }
+
+    if (tree) {
         tree->left = NULL;
         tree->right = NULL;
+        tree->height = 1;
+#if AVLTREE_ORDER_STATISTIC
+        tree->count = 1;
+#endif
         memcpy(tree->data, data, size);
     }
     return tree;
 }
 
+/*
+ * Renvoie la taille a allouer pour un noeud contenant une donnee de 'size' octets.
+ * On part de la position reelle du champ 'data' dans la structure, ce qui tient compte
+ * du remplissage ajoute par le compilateur entre les champs.
+ */
+size_t  AVLtree_nodeSize(size_t size) {
+    return MAX(offsetof(struct AVLTreeNode, data) + size, sizeof(struct AVLTreeNode));
+}
+
+//----------------------------------------
+/*
+ * Construit le sous-arbre des elements [low, high) du tableau trie : l'element du milieu
+ * devient la racine et chaque moitie un fils. Les deux moities different d'au plus un
+ * element, l'arbre obtenu est donc equilibre au mieux et les hauteurs sont exactes.
+ * La recursion est bornee par log2(count). En cas d'echec d'allocation, '*ok' passe a false.
+ */
+static AVLTree AVLtree_buildRange(const AVLOps *ops, const char *array, size_t low, size_t high, size_t elemSize,
+                                  bool *ok) {
+    AVLTree tree;
+    size_t  middle;
+
+    if (low >= high || !*ok)
+        return NULL;
+
+    middle = low + (high - low) / 2;
+    if (!(tree = AVLtree_allocNode(ops, elemSize))) {
+        *ok = false;
+        return NULL;
+    }
+    memcpy(tree->data, array + middle * elemSize, elemSize);
+    tree->left = AVLtree_buildRange(ops, array, low, middle, elemSize, ok);
+    tree->right = AVLtree_buildRange(ops, array, middle + 1, high, elemSize, ok);
+    AVLtree_updateOps(tree, ops);
+    return tree;
+}
+
+/*
+ * Construit en temps lineaire un AVL a partir de 'count' elements de 'elemSize' octets,
+ * deja tries par ordre strictement croissant (sans doublon).
+ * Aucune comparaison ni rotation n'est faite. Renvoie NULL si une allocation echoue.
+ */
+AVLTree AVLtree_buildFromSorted(const void *array, size_t count, size_t elemSize) {
+    return AVLtree_buildFromSortedPool(NULL, array, count, elemSize);
+}
+
+/*
+ * Identique a #AVLtree_buildFromSorted(), les noeuds etant pris dans 'pool'.
+ */
+AVLTree AVLtree_buildFromSortedPool(AVLPool *pool, const void *array, size_t count, size_t elemSize) {
+    AVLOps ops = { .pool = pool };
+
+    return AVLtree_buildFromSortedOps(&ops, array, count, elemSize);
+}
+
+/*
+ * Identique a #AVLtree_buildFromSorted(), les noeuds etant pris dans le pool de 'ops' et
+ * comptes dans ses statistiques ; l'augmentation de 'ops' est calculee sur chaque noeud.
+ */
+AVLTree AVLtree_buildFromSortedOps(const AVLOps *ops, const void *array, size_t count, size_t elemSize) {
+    AVLTree tree;
+    bool    ok;
+
+    ok = true;
+    tree = AVLtree_buildRange(ops, (const char *) array, 0, count, elemSize, &ok);
+    if (!ok)
+        AVLtree_deleteSubtree(&tree, ops);
+    return tree;
+}
+
+/*
+ * Trie sur place 'count' elements de 'elemSize' octets avec 'cmp3' et retire les doublons
+ * (le premier de chaque groupe est garde). Renvoie le nombre d'elements restants, ranges
+ * en tete du tableau par ordre strictement croissant.
+ */
+size_t  AVLtree_sortUnique(void *array, size_t count, size_t elemSize, int (*cmp3)(const void *, const void *)) {
+    char    *elems;
+    size_t  index, nbUnique;
+
+    if (count == 0)
+        return 0;
+
+    elems = (char *) array;
+    qsort(elems, count, elemSize, cmp3);
+
+    nbUnique = 1;
+    for (index = 1; index < count; index++) {
+        if (cmp3(elems + (nbUnique - 1) * elemSize, elems + index * elemSize) != 0) {
+            if (nbUnique != index)
+                memcpy(elems + nbUnique * elemSize, elems + index * elemSize, elemSize);
+            nbUnique++;
+        }
+    }
+    return nbUnique;
+}
+
+/*
+ * Construit un AVL a partir d'un tableau quelconque : le tableau est trie sur place avec
+ * 'cmp3', les doublons sont retires (le premier est garde) puis l'arbre est construit
+ * comme avec #AVLtree_buildFromSorted(). Cout en O(n log n) pour le tri, sans rotation.
+ */
+AVLTree AVLtree_buildFromUnsorted(void *array, size_t count, size_t elemSize, int (*cmp3)(const void *, const void *)) {
+    return AVLtree_buildFromSorted(array, AVLtree_sortUnique(array, count, elemSize, cmp3), elemSize);
+}
+
 //----------------------------------------
 /*
  * Getter sur la valeur 'height' de 'AVLTree'
@@ -82,24 +209,144 @@ bool    AVLtree_setHeight(const AVLTree tree, int height) {
 }
 
 //----------------------------------------
+/*
+ * Pile de parcours utilisee par les mesures iteratives. Elle tient sur la pile d'appel
+ * tant que l'arbre est equilibre et passe sur le tas si on lui donne un arbre degenere.
+ */
+typedef struct AVLStackItem {
+    AVLTree node;
+    size_t  depth;
+} AVLStackItem;
+
+/*
+ * Parcours en profondeur iteratif calculant en un passage le nombre de noeuds et la
+ * hauteur reelle du sous-arbre 'tree'. Les deux compteurs de sortie sont optionnels.
+ */
+static void AVLtree_measure(const AVLTree tree, size_t *size, size_t *height) {
+    AVLStackItem    local[AVLTREE_MAX_HEIGHT + 1];
+    AVLStackItem    *stack, *grown;
+    AVLStackItem    item;
+    size_t          capacity, top, nbNodes, maxDepth;
+
+    stack = local;
+    capacity = AVLTREE_MAX_HEIGHT + 1;
+    top = 0;
+    nbNodes = 0;
+    maxDepth = 0;
+
+    if (tree)
+        stack[top++] = (AVLStackItem) { tree, 1 };
+
+    while (top) {
+        item = stack[--top];
+        nbNodes++;
+        maxDepth = MAX(maxDepth, item.depth);
+
+        if (top + 2 > capacity) {
+            if (stack == local) {
+                grown = (AVLStackItem *) malloc(sizeof(AVLStackItem) * capacity * 2);
+                if (grown)
+                    memcpy(grown, local, sizeof(AVLStackItem) * top);
+            } else {
+                grown = (AVLStackItem *) realloc(stack, sizeof(AVLStackItem) * capacity * 2);
+            }
+            if (!grown)
+                break;
+            stack = grown;
+            capacity *= 2;
+        }
+
+        if (item.node->right)
+            stack[top++] = (AVLStackItem) { item.node->right, item.depth + 1 };
+        if (item.node->left)
+            stack[top++] = (AVLStackItem) { item.node->left, item.depth + 1 };
+    }
+
+    if (stack != local)
+        free(stack);
+    if (size)
+        *size = nbNodes;
+    if (height)
+        *height = maxDepth;
+}
+
 /*
  * Renvoie la profondeur (hauteur de l'arbre) base sur un noeud donne en parametre.
+ * La hauteur est recalculee en parcourant les noeuds, sans se fier au champ 'height'.
  */
 size_t  AVLtree_height_basedToNode(const AVLTree tree) {
-    if (tree)
-        return 1 + MAX (AVLtree_height_basedToNode(tree->left),AVLtree_height_basedToNode(tree->right));
-    else
-        return 0;
+    size_t height;
+
+    AVLtree_measure(tree, NULL, &height);
+    return height;
 }
 
 /*
  * Renvoie le nombre de noeud base sur un noeud donne en parametre.
  */
 size_t  AVLtree_size_basedToNode(const AVLTree tree) {
+    size_t size;
+
+    AVLtree_measure(tree, &size, NULL);
+    return size;
+}
+
+//----------------------------------------
+/*
+ * Renvoie le nombre de noeuds du sous-arbre 'tree'.
+ * Avec l'augmentation statistique d'ordre c'est une simple lecture du champ 'count',
+ * sinon on compte les noeuds.
+ */
+size_t  AVLtree_getSize(const AVLTree tree) {
+#if AVLTREE_ORDER_STATISTIC
     if (tree)
-        return 1 + AVLtree_size_basedToNode(tree->left) + AVLtree_size_basedToNode(tree->right);
-    else
-        return 0;
+        return tree->count;
+    return 0;
+#else
+    return AVLtree_size_basedToNode(tree);
+#endif
+}
+
+/*
+ * Renvoie le rang de 'data', c'est a dire le nombre d'elements strictement plus petits
+ * que 'data' dans l'arbre (que 'data' y soit present ou non).
+ * On descend comme pour une recherche en ajoutant la taille des sous-arbres gauches
+ * laisses de cote.
+ */
+size_t  AVLtree_rank(AVLTree tree, int (*cmp3)(const void *, const void *), const void *data) {
+    size_t rank;
+
+    rank = 0;
+    while (tree) {
+        if (cmp3(data, tree->data) <= 0) {
+            tree = tree->left;
+        } else {
+            rank += AVLtree_getSize(tree->left) + 1;
+            tree = tree->right;
+        }
+    }
+    return rank;
+}
+
+/*
+ * Renvoie le noeud d'indice 'index' (a partir de 0) dans l'ordre des donnees, ou NULL si
+ * l'arbre contient moins de 'index' + 1 elements.
+ */
+AVLTree AVLtree_select(AVLTree tree, size_t index) {
+    size_t leftSize;
+
+    while (tree) {
+        leftSize = AVLtree_getSize(tree->left);
+        if (index < leftSize) {
+            tree = tree->left;
+        } else if (index > leftSize) {
+            index -= leftSize + 1;
+            tree = tree->right;
+        } else {
+            return tree;
+        }
+    }
+    return NULL;
 }
 
 //----------------------------------------
@@ -109,9 +356,11 @@ size_t  AVLtree_size_basedToNode(const AVLTree tree) {
  * correctement complete et que celui-ci est donc la valeur la plus a gauche de l'arbre.
  */
 AVLTree AVLtree_getMIN(const AVLTree node) {
-    if (node && node->left)
-        return AVLtree_getMIN(node->left);
-    return node;
+    AVLTree tree = node;
+
+    while (tree && tree->left)
+        tree = tree->left;
+    return tree;
 }
 
 /*
@@ -120,44 +369,79 @@ AVLTree AVLtree_getMIN(const AVLTree node) {
  * correctement complete et que celui-ci est donc la valeur la plus a droite de l'arbre.
  */
 AVLTree AVLtree_getMAX(const AVLTree node) {
-    if (node && node->right)
-        return AVLtree_getMAX(node->right);
-    return node;
+    AVLTree tree = node;
+
+    while (tree && tree->right)
+        tree = tree->right;
+    return tree;
 }
 
 //----------------------------------------
 /*
- * Fonction de rotation de l'arbre, base sur un noeud.
- * Nous interchangeons les pointeurs pour artificiellement tourner les noeuds vers la gauche.
+ * Recalcule les champs 'height' (et 'count') d'un noeud a partir de ceux de ses fils.
  */
-AVLTree AVLtree_rotateLeft(const AVLTree tree) {
+void    AVLtree_update(const AVLTree tree) {
+    if (tree) {
+        AVLtree_setHeight(tree, MAX(AVLtree_getHeight(tree->left), AVLtree_getHeight(tree->right)) + 1);
+#if AVLTREE_ORDER_STATISTIC
+        tree->count = AVLtree_getSize(tree->left) + AVLtree_getSize(tree->right) + 1;
+#endif
+    }
+}
+
+/*
+ * #AVLtree_update() suivie de l'augmentation de 'ops', s'il y en a une.
+ */
+void    AVLtree_updateOps(const AVLTree tree, const AVLOps *ops) {
+    AVLtree_update(tree);
+    if (ops && ops->augment)
+        ops->augment(tree);
+}
+
+/*
+ * Rotations du moteur : le noeud descendu est mis a jour avant celui qui le remplace,
+ * l'augmentation de 'ops' voit donc toujours des fils a jour.
+ */
+static AVLTree AVLtree_rotateLeftOps(const AVLTree tree, const AVLOps *ops) {
     AVLTree oNode;
 
     oNode = tree->left;
     tree->left = oNode->right;
     oNode->right = tree;
 
-    AVLtree_setHeight(tree, MAX(AVLtree_getHeight(tree->left), AVLtree_getHeight(tree->right)) + 1);
-    AVLtree_setHeight(oNode, MAX(AVLtree_getHeight(oNode->left), tree->height) + 1);
+    AVLtree_updateOps(tree, ops);
+    AVLtree_updateOps(oNode, ops);
     return oNode;
 }
 
-/*
- * Fonction de rotation de l'arbre, base sur un noeud.
- * Nous interchangeons les pointeurs pour artificiellement tourner les noeuds vers la droite.
- */
-AVLTree AVLtree_rotateRight(const AVLTree tree) {
+static AVLTree AVLtree_rotateRightOps(const AVLTree tree, const AVLOps *ops) {
     AVLTree oNode;
 
     oNode = tree->right;
     tree->right = oNode->left;
     oNode->left = tree;
 
-    AVLtree_setHeight(tree, MAX(AVLtree_getHeight(tree->left), AVLtree_getHeight(tree->right)) + 1);
-    AVLtree_setHeight(oNode, MAX(AVLtree_getHeight(oNode->right), tree->height) + 1);
+    AVLtree_updateOps(tree, ops);
+    AVLtree_updateOps(oNode, ops);
     return oNode;
 }
 
+/*
+ * Fonction de rotation de l'arbre, base sur un noeud.
+ * Nous interchangeons les pointeurs pour artificiellement tourner les noeuds vers la gauche.
+ */
+AVLTree AVLtree_rotateLeft(const AVLTree tree) {
+    return AVLtree_rotateLeftOps(tree, NULL);
+}
+
+/*
+ * Fonction de rotation de l'arbre, base sur un noeud.
+ * Nous interchangeons les pointeurs pour artificiellement tourner les noeuds vers la droite.
+ */
+AVLTree AVLtree_rotateRight(const AVLTree tree) {
+    return AVLtree_rotateRightOps(tree, NULL);
+}
+
 /*
  * Fonction de rotation de l'arbre, base sur un noeud.
  * Nous interchangeons les pointeurs pour artificiellement tourner les noeuds vers la droite
@@ -178,252 +462,666 @@ AVLTree AVLtree_doubleRotateRight(const AVLTree tree) {
     return AVLtree_rotateRight(tree);
 }
 
-//----------------------------------------
 /*
- * Recherche et renvoie un noeud base sur la fonction de comparaison donne en parametre ainsi qu'une
- * donne libre. Il est possible de chercher un noeud precis en le donnant comme 'data' et en utilisant
- * une fonction de comparaison adequate.
+ * Compteurs de l'instrumentation (voir AVLStats). Compilee sans AVLTREE_STATS, chaque
+ * macro disparait et aucune instruction n'est ajoutee au moteur.
  */
-AVLTree AVLtree_search(AVLTree tree, bool (*cmp)(const void *, const void *), void *data) {
-    if (tree) {
-        if (cmp(data, tree->data))
-            return AVLtree_search(tree->left, cmp, data);
-        else if (cmp(tree->data, data))
-            return AVLtree_search(tree->right, cmp, data);
-        else
-            return tree;
+#if AVLTREE_STATS
+#define AVLTREE_STATS_ADD(ops, field, n)    do { if ((ops) && (ops)->stats) (ops)->stats->field += (n); } while (0)
+#define AVLTREE_STATS_PATH(ops, length)     do { if ((ops) && (ops)->stats) {                       \
+                                                (ops)->stats->searches++;                           \
+                                                (ops)->stats->pathLength += (length);               \
+                                                (ops)->stats->depthHistogram[(length)]++;           \
+                                            } } while (0)
+#else
+#define AVLTREE_STATS_ADD(ops, field, n)    ((void) 0)
+#define AVLTREE_STATS_PATH(ops, length)     ((void) 0)
+#endif
+
+/*
+ * Reequilibrage commun a #AVLtree_rebalance() et au moteur (insertion, suppression,
+ * jointures), qui compte les rotations et maintient l'augmentation.
+ */
+AVLTree AVLtree_rebalanceOps(const AVLTree tree, const AVLOps *ops) {
+    int balance;
+
+    balance = (int) AVLtree_getHeight(tree->left) - (int) AVLtree_getHeight(tree->right);
+    if (balance > 1) {
+        if (AVLtree_getHeight(tree->left->left) >= AVLtree_getHeight(tree->left->right)) {
+            AVLTREE_STATS_ADD(ops, rotations, 1);
+            return AVLtree_rotateLeftOps(tree, ops);
+        }
+        AVLTREE_STATS_ADD(ops, doubleRotations, 1);
+        tree->left = AVLtree_rotateRightOps(tree->left, ops);
+        return AVLtree_rotateLeftOps(tree, ops);
     }
-    return NULL;
+    if (balance < -1) {
+        if (AVLtree_getHeight(tree->right->right) >= AVLtree_getHeight(tree->right->left)) {
+            AVLTREE_STATS_ADD(ops, rotations, 1);
+            return AVLtree_rotateRightOps(tree, ops);
+        }
+        AVLTREE_STATS_ADD(ops, doubleRotations, 1);
+        tree->right = AVLtree_rotateLeftOps(tree->right, ops);
+        return AVLtree_rotateRightOps(tree, ops);
+    }
+    return tree;
+}
+
+/*
+ * Reequilibre un noeud dont les fils sont des AVL valides mais dont les hauteurs peuvent
+ * differer de deux. Renvoie la nouvelle racine du sous-arbre.
+ * La hauteur de 'tree' doit etre a jour (voir #AVLtree_update()).
+ */
+AVLTree AVLtree_rebalance(const AVLTree tree) {
+    return AVLtree_rebalanceOps(tree, NULL);
 }
 
 //----------------------------------------
 /*
- * Fonction d'insertion de nouvelle donnee recursive.
- * initialement, nous avons la racine en tant que parametre 'tree'.
- * Au fil des recursions, ce parametre va permettre de se deplacer vers un endroit
- * correspondant a l'emplacement voulu en utilisant la fonction de comparaison pointe.
- * L'arrive se caracterise par une fin de parcours (NULL trouve dans une branche) et se suit
- * la creation d'un nouveau noeud avec les parametres 'data' et 'size'.
- * Ce nouveau noeud est remonte lors de la completion de la pile de recursion et positionne au
- * plus bas de l'arbre.
- * S'en suit des tests permettant de savoir si il y a besoin d'effectuer des rotations pour
- * reequilibrer l'arbre. Les bonnes rotations sont donc effectues au fil de la resolution de la
- * recursion.
- * Si la racine devait etre differente car elle ne correspondrait plus aux donnees,
- * celle-ci serait retourne par cette fonction.
+ * Compare 'a' et 'b' selon 'ops' et renvoie un entier <0, 0 ou >0.
+ * Avec un comparateur a trois issues ('cmp3'), un seul appel suffit ; avec l'ancien predicat
+ * 'plus petit que' ('cmp') il en faut deux dans le cas ou 'a' n'est pas plus petit que 'b'.
  */
-AVLTree AVLtree_insertData(AVLTree tree, bool (*cmp)(const void *, const void *), const void *data, size_t size) {
-    if (data) {
-        if (!tree) {
-            if (!(tree = AVLtree_create(data, size)))
-                return NULL;
-        } else if (cmp(data, tree->data)) {
-            tree->left = AVLtree_insertData(tree->left, cmp, data, size);
-
-            if (AVLtree_getHeight(tree->left) - AVLtree_getHeight(tree->right) == 2) {
-                if (cmp(data, tree->left->data))
-                    tree = AVLtree_rotateLeft(tree);
-                else
-                    tree = AVLtree_doubleRotateLeft(tree);
-            }
+int     AVLtree_compare(const AVLOps *ops, const void *a, const void *b) {
+    if (ops->cmp3) {
+        AVLTREE_STATS_ADD(ops, compares, 1);
+        return ops->cmp3(a, b);
+    }
+    AVLTREE_STATS_ADD(ops, compares, 1);
+    if (ops->cmp(a, b))
+        return -1;
+    AVLTREE_STATS_ADD(ops, compares, 1);
+    return ops->cmp(b, a);
+}
 
-        } else if (cmp(tree->data, data)) {
-            tree->right = AVLtree_insertData(tree->right, cmp, data, size);
+/*
+ * Alloue un noeud non initialise pour une donnee de 'size' octets, soit dans le pool de
+ * 'ops', soit avec malloc(). Les liens et la hauteur sont poses par #AVLtree_pathInsert().
+ * Renvoie NULL si la memoire manque ou si la donnee ne tient pas dans les noeuds du pool.
+ */
+AVLTree AVLtree_allocNode(const AVLOps *ops, size_t size) {
+    AVLTree node;
 
-            if (AVLtree_getHeight(tree->right) - AVLtree_getHeight(tree->left) == 2) {
-                if (cmp(tree->right->data, data))
-                    tree = AVLtree_rotateRight(tree);
-                else
-                    tree = AVLtree_doubleRotateRight(tree);
-            }
+    if (ops && ops->pool)
+        node = (size <= ops->pool->dataSize) ? AVLpool_alloc(ops->pool) : NULL;
+    else
+        node = (AVLTree) malloc(AVLtree_nodeSize(size));
+    if (node)
+        AVLTREE_STATS_ADD(ops, nodesCreated, 1);
+    return node;
+}
+
+/*
+ * Libere un noeud, soit dans le pool de 'ops', soit avec free().
+ */
+void    AVLtree_freeNode(const AVLOps *ops, AVLTree node) {
+    AVLTREE_STATS_ADD(ops, nodesFreed, 1);
+    if (ops && ops->pool)
+        AVLpool_free(ops->pool, node);
+    else
+        free(node);
+}
+
+/*
+ * Remonte le chemin 'path' a partir du niveau 'level' jusqu'a la racine en recalculant
+ * les hauteurs et en reequilibrant les noeuds.
+ * Le reequilibrage s'arrete des qu'un noeud retrouve la hauteur qu'il avait avant la
+ * modification : les ancetres ne peuvent alors plus etre desequilibres. Seules les tailles
+ * de sous-arbre et l'augmentation de 'ops' restent alors a mettre a jour jusqu'a la racine.
+ */
+static void AVLtree_retrace(AVLPath *path, int level, const AVLOps *ops) {
+    AVLTree node;
+    void    (*augment)(AVLTree) = (ops) ? ops->augment : NULL;
+    int     oldHeight;
+
+    for (; level >= 0; level--) {
+        node = *path->link[level];
+        oldHeight = node->height;
+
+        AVLtree_update(node);
+        if (augment)
+            augment(node);
+        node = AVLtree_rebalanceOps(node, ops);
+        *path->link[level] = node;
+
+        if (node->height == oldHeight) {
+            level--;
+            break;
+        }
+    }
+
+    if (AVLTREE_ORDER_STATISTIC || augment)
+        for (; level >= 0; level--) {
+            AVLtree_update(*path->link[level]);
+            if (augment)
+                augment(*path->link[level]);
         }
+}
 
-        AVLtree_setHeight(tree, MAX(AVLtree_getHeight(tree->left), AVLtree_getHeight(tree->right))+ 1);
-        return tree;
+/*
+ * Fin commune de #AVLtree_pathFind() et #AVLtree_pathFindHint() : descente depuis '*link',
+ * a la suite des 'path->depth' liens deja enregistres.
+ */
+static AVLTree AVLtree_pathDescend(AVLTree *link, const AVLOps *ops, const void *data, AVLPath *path) {
+    int res;
+
+    while (*link) {
+        path->link[path->depth++] = link;
+        if ((res = AVLtree_compare(ops, data, (*link)->data)) == 0) {
+            AVLTREE_STATS_PATH(ops, path->depth);
+            return *link;
+        }
+        link = (res < 0) ? &(*link)->left : &(*link)->right;
     }
+    AVLTREE_STATS_PATH(ops, path->depth);
+    path->link[path->depth++] = link;
     return NULL;
 }
 
 /*
- * Fonction d'insertion de nouvelle donnee recursive.
- * initialement, nous avons la racine en tant que parametre 'tree'.
- * Au fil des recursions, ce parametre va permettre de se deplacer vers un endroit
- * correspondant a l'emplacement voulu en utilisant la fonction de comparaison pointe.
- * L'arrive se caracterise par une fin de parcours (NULL trouve dans une branche) et se suit
- * le positionnement du noeud entre initialement en parametre.
- * Ce nouveau noeud est remonte lors de la completion de la pile de recursion et positionne au
- * plus bas de l'arbre.
- * S'en suit des tests permettant de savoir si il y a besoin d'effectuer des rotations pour
- * reequilibrer l'arbre. Les bonnes rotations sont donc effectues au fil de la resolution de la
- * recursion.
- * Si la racine devait etre differente car elle ne correspondrait plus aux donnees,
- * celle-ci serait retourne par cette fonction.
+ * Descend iterativement depuis '*root' vers la place de 'data' en enregistrant dans 'path'
+ * l'adresse de chaque lien emprunte ('path->link[0]' vaut 'root').
+ * Le dernier lien enregistre designe le noeud trouve, ou l'emplacement vide ou il faudrait
+ * l'inserer. Renvoie le noeud trouve ou NULL.
+ * Le chemin reste valide tant que l'arbre n'est pas modifie par ailleurs, et peut etre
+ * passe a #AVLtree_pathInsert() ou #AVLtree_pathRemove().
  */
-AVLTree AVLtree_insertNode(AVLTree tree, bool (*cmp) (const void *, const void *), const AVLTree newNode) {
-    if (newNode && newNode->data) {
-        if (!tree) {
-            tree = newNode;
-        } else if (cmp(newNode->data, tree->data)) {
-            tree->left = AVLtree_insertNode(tree->left, cmp, newNode);
-
-            if (AVLtree_getHeight(tree->left) - AVLtree_getHeight(tree->right) == 2) {
-                if (cmp(newNode->data, tree->left->data))
-                    tree = AVLtree_rotateLeft(tree);
-                else
-                    tree = AVLtree_doubleRotateLeft(tree);
-            }
+AVLTree AVLtree_pathFind(AVLTree *root, const AVLOps *ops, const void *data, AVLPath *path) {
+    path->depth = 0;
+    return AVLtree_pathDescend(root, ops, data, path);
+}
 
-        } else if (cmp(tree->data, newNode->data)) {
-            tree->right = AVLtree_insertNode(tree->right, cmp, newNode);
+/*
+ * Identique a #AVLtree_pathFind(), en partant d'un doigt : 'finger' donne les 'depth'
+ * noeuds du chemin de la racine jusqu'a un noeud proche de 'data' (la pile d'un curseur,
+ * le chemin de la derniere insertion...). On remonte ce chemin en ne comparant 'data'
+ * qu'aux ancetres qui bornent le sous-arbre du cote de 'data', jusqu'au plus profond
+ * sous-arbre qui peut le contenir, puis on redescend normalement. Pour une donnee voisine
+ * du doigt, il suffit de quelques comparaisons au lieu d'une par niveau.
+ * Un doigt vide ou qui ne part pas de '*root' est ignore ; les liens du chemin sont
+ * retrouves sans comparaison a partir des noeuds du doigt.
+ */
+AVLTree AVLtree_pathFindHint(AVLTree *root, const AVLOps *ops, const AVLTree finger[], int depth, const void *data,
+                             AVLPath *path) {
+    AVLTree *link;
+    int     level, start, res, turn;
+
+    if (depth <= 0 || finger[0] != *root)
+        return AVLtree_pathFind(root, ops, data, path);
 
-            if (AVLtree_getHeight(tree->right) - AVLtree_getHeight(tree->left) == 2) {
-                if (cmp(tree->right->data, newNode->data))
-                    tree = AVLtree_rotateRight(tree);
-                else
-                    tree = AVLtree_doubleRotateRight(tree);
+    start = depth - 1;
+    if ((res = AVLtree_compare(ops, data, finger[start]->data)) != 0) {
+        for (level = depth - 2; level >= 0; level--) {
+            //seuls les ancetres d'ou le doigt part du cote oppose a 'data' bornent le sous-arbre
+            if ((res > 0) != (finger[level + 1] == finger[level]->left))
+                continue;
+            turn = AVLtree_compare(ops, data, finger[level]->data);
+            if (turn != 0 && (turn > 0) != (res > 0))
+                break;
+            start = level;
+            if (turn == 0) {
+                res = 0;
+                break;
             }
         }
+    }
 
-        AVLtree_setHeight(tree, MAX(AVLtree_getHeight(tree->left), AVLtree_getHeight(tree->right))+ 1);
-        return tree;
+    link = root;
+    for (level = 0; level < start; level++) {
+        path->link[level] = link;
+        link = (finger[level + 1] == finger[level]->left) ? &finger[level]->left : &finger[level]->right;
     }
-    return NULL;
+    path->link[start] = link;
+    path->depth = start + 1;
+    if (res == 0) {
+        AVLTREE_STATS_PATH(ops, path->depth);
+        return *link;
+    }
+    link = (res < 0) ? &(*link)->left : &(*link)->right;
+    return AVLtree_pathDescend(link, ops, data, path);
 }
 
-//----------------------------------------
 /*
-* Fonction de suppression de noeud.
-* Celle-ci va d'abord se positionner par recursion sur le noeud correspondant au noeud voulant être supprime.
-* Apres, nous separons les etats entre les noeuds possedant 0 ou 1 fils et le reste pour effecter un traitement
-* permettant de liberer la memoire.
-* A la suite, nous changeons la taille du noeud et balancons les noeuds si nous avons besoin avant de le
-* retourner pour depiler la recursion et refaire ces operations.
-*/
-AVLTree AVLtree_deleteNode(AVLTree tree, bool (*cmp) (const void *, const void *), const AVLTree delNode) {
-    if (tree == NULL)
-        return tree;
+ * Accroche 'node' a l'emplacement vide qui termine 'path' (obtenu par #AVLtree_pathFind()
+ * sans succes) puis reequilibre en remontant le chemin.
+ */
+void    AVLtree_pathInsert(AVLPath *path, const AVLOps *ops, AVLTree node) {
+    node->left = NULL;
+    node->right = NULL;
+    node->height = 1;
+#if AVLTREE_ORDER_STATISTIC
+    node->count = 1;
+#endif
+    if (ops && ops->augment)
+        ops->augment(node);
+    *path->link[path->depth - 1] = node;
+
+    AVLtree_retrace(path, path->depth - 2, ops);
+}
 
-    if (cmp(delNode->data, tree->data)) {
-        tree->left = AVLtree_deleteNode(tree->left, cmp, delNode);
+/*
+ * Decroche de l'arbre le noeud qui termine 'path' (obtenu par #AVLtree_pathFind() avec
+ * succes), reequilibre, et renvoie ce noeud sans le liberer.
+ * Un noeud a deux fils est remplace par son successeur : on modifie les liens, la donnee
+ * des noeuds n'est jamais recopiee.
+ */
+AVLTree AVLtree_pathRemove(AVLPath *path, const AVLOps *ops) {
+    AVLTree *link, *succLink;
+    AVLTree node, succ;
+    int     level, start;
 
-    } else if (cmp(tree->data, delNode->data)) {
-        tree->right = AVLtree_deleteNode(tree->right, cmp, delNode);
+    level = path->depth - 1;
+    link = path->link[level];
+    node = *link;
 
+    if (!node->left || !node->right) {
+        *link = (node->left) ? node->left : node->right;
+        start = level - 1;
     } else {
-        if (!tree->left || !tree->right) {
-            AVLTree oNode;
+        start = level + 1;
+        succLink = &node->right;
+        path->link[start] = succLink;
+        while ((*succLink)->left) {
+            succLink = &(*succLink)->left;
+            path->link[++start] = succLink;
+        }
 
-            oNode = (tree->left) ? tree->left : tree->right;
-            if (!oNode) {
-                oNode = tree;
-                tree = NULL;
-            } else {
-                *tree = *oNode;
-            }
-            free(oNode);
-        } else {
-            AVLTree oNode;
+        succ = *succLink;
+        *succLink = succ->right;
+        succ->left = node->left;
+        succ->right = node->right;
+        succ->height = node->height;
+        *link = succ;
+        path->link[level + 1] = &succ->right;
+        start--;
+    }
 
-            oNode = tree->right;
-            while (oNode->left)
-                oNode = oNode->left;
+    AVLtree_retrace(path, start, ops);
+    node->left = NULL;
+    node->right = NULL;
+    return node;
+}
 
-            *tree->data = *oNode->data;
-            tree->right = AVLtree_deleteNode(tree->right, cmp, delNode);
+//----------------------------------------
+/*
+ * Recherche iterative d'un noeud egal a 'data' selon 'ops'.
+ */
+AVLTree AVLtree_searchOps(AVLTree tree, const AVLOps *ops, const void *data) {
+    int res;
+#if AVLTREE_STATS
+    int depth = 0;
+#endif
+
+    while (tree) {
+#if AVLTREE_STATS
+        depth++;
+#endif
+        if ((res = AVLtree_compare(ops, data, tree->data)) < 0)
+            tree = tree->left;
+        else if (res > 0)
+            tree = tree->right;
+        else
+            break;
+    }
+    AVLTREE_STATS_PATH(ops, depth);
+    return tree;
+}
+
+/*
+ * Recherche et renvoie un noeud base sur la fonction de comparaison donne en parametre ainsi qu'une
+ * donne libre. Il est possible de chercher un noeud precis en le donnant comme 'data' et en utilisant
+ * une fonction de comparaison adequate.
+ */
+AVLTree AVLtree_search(AVLTree tree, bool (*cmp)(const void *, const void *), void *data) {
+    AVLOps ops = { .cmp = cmp };
+
+    return AVLtree_searchOps(tree, &ops, data);
+}
+
+/*
+ * Identique a #AVLtree_search() avec un comparateur a trois issues : 'cmp3(a, b)' renvoie
+ * une valeur negative si a < b, nulle si a == b et positive si a > b.
+ * Une seule comparaison est faite par niveau.
+ */
+AVLTree AVLtree_search3(AVLTree tree, int (*cmp3)(const void *, const void *), const void *data) {
+    AVLOps ops = { .cmp3 = cmp3 };
+
+    return AVLtree_searchOps(tree, &ops, data);
+}
+
+/*
+ * Recherche de 'count' cles d'un coup : results[i] recoit le noeud egal a keys[i] ou NULL.
+ * Les descentes avancent de front, un niveau a la fois, par groupes de
+ * AVLTREE_BATCH_WIDTH : pendant qu'on compare une cle, les fils choisis pour les autres
+ * sont deja en cours de chargement (__builtin_prefetch), ce qui recouvre les defauts de
+ * cache des descentes independantes. Les descentes terminees sont retirees du groupe.
+ */
+void    AVLtree_searchBatchOps(AVLTree tree, const AVLOps *ops, const void *const keys[], size_t count,
+                               AVLTree results[]) {
+    AVLTree node[AVLTREE_BATCH_WIDTH];
+    size_t  lane[AVLTREE_BATCH_WIDTH];
+    size_t  start, nbActive, i;
+    int     res;
+#if AVLTREE_STATS
+    int     depth[AVLTREE_BATCH_WIDTH];
+#endif
+
+    for (start = 0; start < count; start += AVLTREE_BATCH_WIDTH) {
+        nbActive = 0;
+        for (i = start; i < count && i < start + AVLTREE_BATCH_WIDTH; i++) {
+            results[i] = NULL;
+            if (tree) {
+                node[nbActive] = tree;
+                lane[nbActive] = i;
+#if AVLTREE_STATS
+                depth[nbActive] = 0;
+#endif
+                nbActive++;
+            }
+        }
+
+        while (nbActive) {
+            for (i = 0; i < nbActive; ) {
+#if AVLTREE_STATS
+                depth[i]++;
+#endif
+                if ((res = AVLtree_compare(ops, keys[lane[i]], node[i]->data)) == 0)
+                    results[lane[i]] = node[i];
+                else if ((node[i] = (res < 0) ? node[i]->left : node[i]->right)) {
+                    __builtin_prefetch(node[i]);
+                    i++;
+                    continue;
+                }
+                AVLTREE_STATS_PATH(ops, depth[i]);
+                nbActive--;
+                node[i] = node[nbActive];
+                lane[i] = lane[nbActive];
+#if AVLTREE_STATS
+                depth[i] = depth[nbActive];
+#endif
+            }
         }
     }
+}
 
-    if (tree == NULL)
-        return tree;
+/*
+ * Identique a #AVLtree_searchBatchOps() avec un comparateur a trois issues.
+ */
+void    AVLtree_searchBatch(AVLTree tree, int (*cmp3)(const void *, const void *), const void *const keys[],
+                            size_t count, AVLTree results[]) {
+    AVLOps ops = { .cmp3 = cmp3 };
 
-    AVLtree_setHeight(tree, MAX(AVLtree_getHeight(tree->left), AVLtree_getHeight(tree->right))+ 1);
+    AVLtree_searchBatchOps(tree, &ops, keys, count, results);
+}
 
-    int balance = AVLtree_getHeight(tree->left) - AVLtree_getHeight(tree->right);
-    if (balance > 1 && (AVLtree_getHeight(tree->left->left) - AVLtree_getHeight(tree->left->right)) >= 0)
-        return AVLtree_rotateLeft(tree);
-    if (balance > 1 && (AVLtree_getHeight(tree->left->left) - AVLtree_getHeight(tree->left->right)) < 0)
-        return AVLtree_doubleRotateLeft(tree);
+//----------------------------------------
+/*
+ * Insertion iterative de 'data' selon 'ops'.
+ * Le chemin de descente est garde dans une pile de taille fixe, puis remonte pour
+ * reequilibrer jusqu'a ce que la hauteur ne change plus. Une donnee deja presente
+ * n'est pas inseree. Renvoie la nouvelle racine.
+ */
+AVLTree AVLtree_insertOps(AVLTree tree, const AVLOps *ops, const void *data, size_t size) {
+    AVLPath path;
+    AVLTree node;
+
+    if (!AVLtree_pathFind(&tree, ops, data, &path)) {
+        if ((node = AVLtree_createPool(ops->pool, data, size))) {
+            AVLTREE_STATS_ADD(ops, nodesCreated, 1);
+            AVLtree_pathInsert(&path, ops, node);
+        }
+    }
+    return tree;
+}
 
-    if (balance < -1 && (AVLtree_getHeight(tree->right->left) - AVLtree_getHeight(tree->right->right)) <= 0)
-        return AVLtree_rotateRight(tree);
-    if (balance < -1 && (AVLtree_getHeight(tree->right->left) - AVLtree_getHeight(tree->right->right)) > 0)
-        return AVLtree_doubleRotateRight(tree);
+/*
+ * Identique a #AVLtree_insertOps() avec un noeud deja cree. Si un noeud egal est deja
+ * present, 'newNode' n'est pas insere et reste a la charge de l'appelant.
+ */
+AVLTree AVLtree_insertNodeOps(AVLTree tree, const AVLOps *ops, AVLTree newNode) {
+    AVLPath path;
 
+    if (!AVLtree_pathFind(&tree, ops, newNode->data, &path))
+        AVLtree_pathInsert(&path, ops, newNode);
     return tree;
 }
 
+/*
+ * Fonction d'insertion de nouvelle donnee.
+ * initialement, nous avons la racine en tant que parametre 'tree'.
+ * On descend depuis la racine vers l'emplacement voulu en utilisant la fonction de comparaison
+ * pointe, en memorisant le chemin parcouru.
+ * L'arrive se caracterise par une fin de parcours (NULL trouve dans une branche) et se suit
+ * la creation d'un nouveau noeud avec les parametres 'data' et 'size', place au plus bas de
+ * l'arbre.
+ * S'en suit la remontee du chemin memorise permettant de savoir si il y a besoin d'effectuer
+ * des rotations pour reequilibrer l'arbre.
+ * Si la racine devait etre differente car elle ne correspondrait plus aux donnees,
+ * celle-ci serait retourne par cette fonction.
+ */
+AVLTree AVLtree_insertData(AVLTree tree, bool (*cmp)(const void *, const void *), const void *data, size_t size) {
+    return AVLtree_insertDataPool(NULL, tree, cmp, data, size);
+}
+
+/*
+ * Identique a #AVLtree_insertData(), les nouveaux noeuds etant pris dans 'pool'.
+ */
+AVLTree AVLtree_insertDataPool(AVLPool *pool, AVLTree tree, bool (*cmp)(const void *, const void *), const void *data, size_t size) {
+    AVLOps ops = { .cmp = cmp, .pool = pool };
+
+    if (data)
+        return AVLtree_insertOps(tree, &ops, data, size);
+    return NULL;
+}
 
 /*
- * Fonction de suppression de noeud.
- * Celle-ci va d'abord se positionner par recursion sur le noeud correspondant au noeud voulant être supprime.
- * Apres, nous separons les etats entre les noeuds possedant 0 ou 1 fils et le reste pour effecter un traitement
- * permettant de liberer la memoire.
- * A la suite, nous changeons la taille du noeud et balancons les noeuds si nous avons besoin avant de le
- * retourner pour depiler la recursion et refaire ces operations.
+ * Identique a #AVLtree_insertData() avec un comparateur a trois issues.
  */
-AVLTree AVLtree_deleteData(AVLTree tree, bool (*cmp) (const void *, const void *), void *data) {
-    if (tree == NULL)
-        return tree;
+AVLTree AVLtree_insertData3(AVLTree tree, int (*cmp3)(const void *, const void *), const void *data, size_t size) {
+    AVLOps ops = { .cmp3 = cmp3 };
 
-    if (cmp(data, tree->data)) {
-        tree->left = AVLtree_deleteData(tree->left, cmp, data);
+    if (data)
+        return AVLtree_insertOps(tree, &ops, data, size);
+    return NULL;
+}
 
-    } else if (cmp(tree->data, data)) {
-        tree->right = AVLtree_deleteData(tree->right, cmp, data);
+/*
+ * Fonction d'insertion d'un noeud deja cree.
+ * Meme fonctionnement que #AVLtree_insertData() : descente memorisee jusqu'a un emplacement
+ * vide, positionnement du noeud entre initialement en parametre, puis remontee du chemin
+ * pour reequilibrer l'arbre.
+ * Si la racine devait etre differente car elle ne correspondrait plus aux donnees,
+ * celle-ci serait retourne par cette fonction.
+ */
+AVLTree AVLtree_insertNode(AVLTree tree, bool (*cmp) (const void *, const void *), const AVLTree newNode) {
+    AVLOps ops = { .cmp = cmp };
 
-    } else {
-        if (!tree->left || !tree->right) {
-            AVLTree oNode;
+    if (newNode)
+        return AVLtree_insertNodeOps(tree, &ops, newNode);
+    return NULL;
+}
 
-            oNode = (tree->left) ? tree->left : tree->right;
-            if (!oNode) {
-                oNode = tree;
-                tree = NULL;
-            } else {
-                *tree = *oNode;
-            }
-            free(oNode);
-        } else {
-            AVLTree oNode;
+/*
+ * Identique a #AVLtree_insertNode() avec un comparateur a trois issues.
+ */
+AVLTree AVLtree_insertNode3(AVLTree tree, int (*cmp3)(const void *, const void *), const AVLTree newNode) {
+    AVLOps ops = { .cmp3 = cmp3 };
+
+    if (newNode)
+        return AVLtree_insertNodeOps(tree, &ops, newNode);
+    return NULL;
+}
 
-            oNode = tree->right;
-            while (oNode->left)
-                oNode = oNode->left;
+//----------------------------------------
+/*
+ * Suppression iterative du noeud egal a 'data' selon 'ops'.
+ * Meme moteur que l'insertion : descente memorisee, decrochage du noeud (remplace par son
+ * successeur s'il a deux fils) puis remontee jusqu'a ce que la hauteur ne change plus.
+ * Le noeud est libere (dans le pool de 'ops' s'il y en a un). Renvoie la nouvelle racine.
+ */
+AVLTree AVLtree_deleteOps(AVLTree tree, const AVLOps *ops, const void *data) {
+    AVLPath path;
 
-            *tree->data = *oNode->data;
-            tree->right = AVLtree_deleteData(tree->right, cmp, data);
-        }
-    }
+    if (AVLtree_pathFind(&tree, ops, data, &path))
+        AVLtree_freeNode(ops, AVLtree_pathRemove(&path, ops));
+    return tree;
+}
 
-    if (tree == NULL)
-        return tree;
+/*
+* Fonction de suppression de noeud.
+* Celle-ci va d'abord se positionner sur le noeud correspondant au noeud voulant être supprime,
+* en memorisant le chemin parcouru.
+* Un noeud possedant 0 ou 1 fils est remplace par ce fils, un noeud a deux fils par son
+* successeur, puis la memoire est liberee.
+* A la suite, nous remontons le chemin pour changer la taille des noeuds et les balancer si
+* nous en avons besoin.
+*/
+AVLTree AVLtree_deleteNode(AVLTree tree, bool (*cmp) (const void *, const void *), const AVLTree delNode) {
+    return AVLtree_deleteNodePool(NULL, tree, cmp, delNode);
+}
 
-    AVLtree_setHeight(tree, MAX(AVLtree_getHeight(tree->left), AVLtree_getHeight(tree->right))+ 1);
+/*
+ * Identique a #AVLtree_deleteNode(), le noeud libere etant rendu a 'pool'.
+ */
+AVLTree AVLtree_deleteNodePool(AVLPool *pool, AVLTree tree, bool (*cmp) (const void *, const void *), const AVLTree delNode) {
+    AVLOps ops = { .cmp = cmp, .pool = pool };
 
-    int balance = AVLtree_getHeight(tree->left) - AVLtree_getHeight(tree->right);
-    if (balance > 1 && (AVLtree_getHeight(tree->left->left) - AVLtree_getHeight(tree->left->right)) >= 0)
-        return AVLtree_rotateRight(tree);
-    if (balance > 1 && (AVLtree_getHeight(tree->left->left) - AVLtree_getHeight(tree->left->right)) < 0)
-        return AVLtree_doubleRotateRight(tree);
+    return AVLtree_deleteOps(tree, &ops, delNode->data);
+}
 
-    if (balance < -1 && (AVLtree_getHeight(tree->right->left) - AVLtree_getHeight(tree->right->right)) <= 0)
-        return AVLtree_rotateLeft(tree);
-    if (balance < -1 && (AVLtree_getHeight(tree->right->left) - AVLtree_getHeight(tree->right->right)) > 0)
-        return AVLtree_doubleRotateLeft(tree);
+/*
+ * Identique a #AVLtree_deleteNode() avec un comparateur a trois issues.
+ */
+AVLTree AVLtree_deleteNode3(AVLTree tree, int (*cmp3)(const void *, const void *), const AVLTree delNode) {
+    AVLOps ops = { .cmp3 = cmp3 };
 
-    return tree;
+    return AVLtree_deleteOps(tree, &ops, delNode->data);
+}
+
+/*
+ * Fonction de suppression de donnee.
+ * Meme fonctionnement que #AVLtree_deleteNode(), le noeud a supprimer etant celui egal a 'data'.
+ */
+AVLTree AVLtree_deleteData(AVLTree tree, bool (*cmp) (const void *, const void *), void *data) {
+    return AVLtree_deleteDataPool(NULL, tree, cmp, data);
+}
+
+/*
+ * Identique a #AVLtree_deleteData(), le noeud libere etant rendu a 'pool'.
+ */
+AVLTree AVLtree_deleteDataPool(AVLPool *pool, AVLTree tree, bool (*cmp) (const void *, const void *), void *data) {
+    AVLOps ops = { .cmp = cmp, .pool = pool };
+
+    return AVLtree_deleteOps(tree, &ops, data);
+}
+
+/*
+ * Identique a #AVLtree_deleteData() avec un comparateur a trois issues.
+ */
+AVLTree AVLtree_deleteData3(AVLTree tree, int (*cmp3)(const void *, const void *), const void *data) {
+    AVLOps ops = { .cmp3 = cmp3 };
+
+    return AVLtree_deleteOps(tree, &ops, data);
 }
 
 /*
  * Fonction permettant de libérer la mémoire de tout l'arbre
+ * Le parcours est iteratif et sans pile : tant que le noeud courant a un fils gauche on
+ * fait tourner l'arbre pour le remonter, sinon on libere le noeud et on passe a droite.
+ * La profondeur de l'arbre n'a donc aucune importance.
  */
 void    AVLtree_deleteTree(AVLTree *tree) {
-    if (*tree) {
-        AVLtree_deleteTree(&((*tree)->left));
-        AVLtree_deleteTree(&((*tree)->right));
-        free(*tree);
+    AVLtree_deleteTreeOps(tree, NULL);
+}
+
+/*
+ * Identique a #AVLtree_deleteTree(), les noeuds etant liberes selon 'ops'.
+ * Avec un pool, celui-ci etant propre a l'arbre, on rend ses slabs en bloc sans parcourir
+ * les noeuds.
+ */
+void    AVLtree_deleteTreeOps(AVLTree *tree, const AVLOps *ops) {
+    if (ops && ops->pool) {
+        AVLTREE_STATS_ADD(ops, nodesFreed, AVLpool_getSize(ops->pool));
+        AVLpool_release(ops->pool);
         *tree = NULL;
+        return;
     }
+    AVLtree_deleteSubtree(tree, ops);
+}
+
+/*
+ * Libere un a un les noeuds du sous-arbre '*tree' selon 'ops'.
+ * Contrairement a #AVLtree_deleteTreeOps(), le pool n'est jamais vide en bloc : a utiliser
+ * lorsqu'il contient aussi d'autres noeuds.
+ */
+void    AVLtree_deleteSubtree(AVLTree *tree, const AVLOps *ops) {
+    AVLtree_deleteSubtreeSteps(tree, ops, SIZE_MAX);
+}
+
+/*
+ * Comme #AVLtree_deleteSubtree(), en s'arretant apres 'budget' etapes (une etape est une
+ * rotation ou une liberation). '*tree' recoit ce qui reste a liberer : un arbre binaire
+ * quelconque, plus un AVL, a reprendre au meme endroit lors de l'appel suivant.
+ * Chaque noeud ne remonte qu'une fois par rotation sur la branche droite : la destruction
+ * complete demande au plus 2n etapes. Renvoie le nombre de noeuds liberes.
+ */
+size_t  AVLtree_deleteSubtreeSteps(AVLTree *tree, const AVLOps *ops, size_t budget) {
+    AVLTree node, oNode;
+    size_t  nbFreed;
+
+    nbFreed = 0;
+    node = *tree;
+    for (; node && budget; budget--) {
+        if (node->left) {
+            oNode = node->left;
+            node->left = oNode->right;
+            oNode->right = node;
+            node = oNode;
+        } else {
+            oNode = node->right;
+            AVLtree_freeNode(ops, node);
+            node = oNode;
+            nbFreed++;
+        }
+    }
+    *tree = node;
+    return nbFreed;
+}
+
+//----------------------------------------
+/*
+ * Copie dans 'stats' les compteurs de 'ops'. Renvoie false, avec des compteurs nuls, si
+ * l'instrumentation n'est pas compilee ou si 'ops' n'a pas de compteurs.
+ */
+bool    AVLtree_stats(const AVLOps *ops, AVLStats *stats) {
+#if AVLTREE_STATS
+    if (ops && ops->stats) {
+        *stats = *ops->stats;
+        return true;
+    }
+#endif
+    memset(stats, 0, sizeof(AVLStats));
+    return false;
+}
+
+/*
+ * Remet a zero les compteurs de 'ops'.
+ */
+void    AVLtree_statsReset(const AVLOps *ops) {
+#if AVLTREE_STATS
+    if (ops && ops->stats)
+        memset(ops->stats, 0, sizeof(AVLStats));
+#endif
+}
+
+/*
+ * Libere tout l'arbre alloue dans 'pool'.
+ * Sans pool, on retombe sur #AVLtree_deleteTree().
+ */
+void    AVLtree_deleteTreePool(AVLPool *pool, AVLTree *tree) {
+    AVLOps ops = { .pool = pool };
+
+    AVLtree_deleteTreeOps(tree, &ops);
 }
 
 //----------------------------------------
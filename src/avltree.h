@@ -6,13 +6,95 @@
 
 
 typedef struct AVLTreeNode *AVLTree;
+typedef struct AVLPool     AVLPool;
+typedef struct AVLOps      AVLOps;
+typedef struct AVLPath     AVLPath;
+typedef struct AVLStats    AVLStats;
+
+/*
+ * Borne sur la hauteur d'un AVL : 1.44 * log2(n + 2) reste sous 96 pour tout n adressable.
+ * Elle dimensionne les piles de chemin des fonctions iteratives.
+ */
+#define AVLTREE_MAX_HEIGHT      96
+
+/*
+ * Nombre de descentes menees de front par #AVLtree_searchBatch().
+ */
+#define AVLTREE_BATCH_WIDTH     16
+
+/*
+ * Augmentation 'statistique d'ordre' : chaque noeud garde la taille de son sous-arbre,
+ * ce qui donne rang, selection et taille en temps logarithmique (ou constant).
+ * Compiler avec -DAVLTREE_ORDER_STATISTIC=0 pour retirer le champ des noeuds ; les memes
+ * fonctions retombent alors sur des parcours.
+ */
+#ifndef AVLTREE_ORDER_STATISTIC
+#define AVLTREE_ORDER_STATISTIC 1
+#endif
 struct          AVLTreeNode {
         AVLTree left;
         AVLTree right;
         int     height;
+#if AVLTREE_ORDER_STATISTIC
+        unsigned int count;
+#endif
         char    data[1];
 };
 
+/*
+ * Instrumentation : compiler avec -DAVLTREE_STATS=1 pour que le moteur compte son travail
+ * dans la structure 'stats' de AVLOps, quand elle est fournie. Sans cette option le champ
+ * n'existe pas et aucun compteur n'est compile.
+ * 'searches' compte les descentes (recherche, insertion, suppression), 'pathLength' la somme
+ * de leurs longueurs en noeuds visites et 'depthHistogram' leur repartition par longueur.
+ * Les compteurs ne sont pas atomiques : un meme 'stats' ne doit pas servir a plusieurs
+ * threads a la fois.
+ */
+#ifndef AVLTREE_STATS
+#define AVLTREE_STATS 0
+#endif
+struct          AVLStats {
+        unsigned long   compares;
+        unsigned long   rotations;
+        unsigned long   doubleRotations;
+        unsigned long   nodesCreated;
+        unsigned long   nodesFreed;
+        unsigned long   searches;
+        unsigned long   pathLength;
+        unsigned long   depthHistogram[AVLTREE_MAX_HEIGHT + 1];
+};
+
+/*
+ * Parametres du moteur d'insertion/suppression : un comparateur (a trois issues 'cmp3'
+ * de preference, sinon le predicat 'plus petit que' 'cmp'), un pool optionnel et, si
+ * l'instrumentation est compilee, des compteurs optionnels.
+ * 'augment', s'il est fourni, recalcule un agregat range dans la donnee d'un noeud (somme,
+ * minimum, plus grande borne d'intervalle...) a partir de sa donnee et de celles de ses
+ * fils, deja a jour. Le moteur l'appelle sur chaque noeud dont un sous-arbre change :
+ * nouveau noeud, rotations et toute la remontee jusqu'a la racine. Les fonctions qui
+ * recoivent 'ops' le maintiennent toutes, y compris celles de avlsetops.h (coupes,
+ * jointures, operations ensemblistes, lots). Celles qui ne le recoivent pas
+ * (#AVLtree_join(), #AVLtree_join2(), #AVLtree_buildFromSorted(), #AVLtree_rebalance(),
+ * rotations...) ne l'appellent pas : utiliser leur variante 'Ops'.
+ */
+struct          AVLOps {
+        int     (*cmp3)(const void *, const void *);
+        bool    (*cmp)(const void *, const void *);
+        AVLPool *pool;
+#if AVLTREE_STATS
+        AVLStats *stats;
+#endif
+        void    (*augment)(AVLTree node);
+};
+
+/*
+ * Chemin de descente : adresses des liens empruntes depuis la racine ('link[0]').
+ */
+struct          AVLPath {
+        AVLTree *link[AVLTREE_MAX_HEIGHT];
+        int     depth;
+};
+
 /*--------------------------------------------------------------------*/
 AVLTree AVLtree_new();
 
@@ -20,6 +102,15 @@ AVLTree AVLtree_new();
 void    *AVLtree_getData(const AVLTree tree);
 bool    AVLtree_setData(const AVLTree tree, const void *data, size_t size);
 AVLTree AVLtree_create(const void *data, size_t size);
+AVLTree AVLtree_createPool(AVLPool *pool, const void *data, size_t size);
+size_t  AVLtree_nodeSize(size_t size);
+
+//----------------------------------------
+AVLTree AVLtree_buildFromSorted(const void *array, size_t count, size_t elemSize);
+AVLTree AVLtree_buildFromSortedPool(AVLPool *pool, const void *array, size_t count, size_t elemSize);
+AVLTree AVLtree_buildFromSortedOps(const AVLOps *ops, const void *array, size_t count, size_t elemSize);
+AVLTree AVLtree_buildFromUnsorted(void *array, size_t count, size_t elemSize, int (*cmp3)(const void *, const void *));
+size_t  AVLtree_sortUnique(void *array, size_t count, size_t elemSize, int (*cmp3)(const void *, const void *));
 
 //----------------------------------------
 size_t  AVLtree_getHeight(const AVLTree tree);
@@ -29,6 +120,11 @@ bool    AVLtree_setHeight(const AVLTree tree, int height);
 size_t  AVLtree_height_basedToNode(const AVLTree tree);
 size_t  AVLtree_size_basedToNode(const AVLTree tree);
 
+//----------------------------------------
+size_t  AVLtree_getSize(const AVLTree tree);
+size_t  AVLtree_rank(AVLTree tree, int (*cmp3)(const void *, const void *), const void *data);
+AVLTree AVLtree_select(AVLTree tree, size_t index);
+
 //----------------------------------------
 AVLTree AVLtree_getMIN(const AVLTree node);
 AVLTree AVLtree_getMAX(const AVLTree node);
@@ -39,17 +135,59 @@ AVLTree AVLtree_rotateRight(const AVLTree tree);
 AVLTree AVLtree_doubleRotateLeft(const AVLTree tree);
 AVLTree AVLtree_doubleRotateRight(const AVLTree tree);
 
+//----------------------------------------
+void    AVLtree_update(const AVLTree tree);
+void    AVLtree_updateOps(const AVLTree tree, const AVLOps *ops);
+AVLTree AVLtree_rebalance(const AVLTree tree);
+AVLTree AVLtree_rebalanceOps(const AVLTree tree, const AVLOps *ops);
+
+//----------------------------------------
+int     AVLtree_compare(const AVLOps *ops, const void *a, const void *b);
+AVLTree AVLtree_allocNode(const AVLOps *ops, size_t size);
+void    AVLtree_freeNode(const AVLOps *ops, AVLTree node);
+AVLTree AVLtree_pathFind(AVLTree *root, const AVLOps *ops, const void *data, AVLPath *path);
+AVLTree AVLtree_pathFindHint(AVLTree *root, const AVLOps *ops, const AVLTree finger[], int depth, const void *data,
+                             AVLPath *path);
+void    AVLtree_pathInsert(AVLPath *path, const AVLOps *ops, AVLTree node);
+AVLTree AVLtree_pathRemove(AVLPath *path, const AVLOps *ops);
+
+//----------------------------------------
+AVLTree AVLtree_searchOps(AVLTree tree, const AVLOps *ops, const void *data);
+AVLTree AVLtree_insertOps(AVLTree tree, const AVLOps *ops, const void *data, size_t size);
+AVLTree AVLtree_insertNodeOps(AVLTree tree, const AVLOps *ops, AVLTree newNode);
+AVLTree AVLtree_deleteOps(AVLTree tree, const AVLOps *ops, const void *data);
+void    AVLtree_deleteTreeOps(AVLTree *tree, const AVLOps *ops);
+void    AVLtree_deleteSubtree(AVLTree *tree, const AVLOps *ops);
+size_t  AVLtree_deleteSubtreeSteps(AVLTree *tree, const AVLOps *ops, size_t budget);
+
+//----------------------------------------
+bool    AVLtree_stats(const AVLOps *ops, AVLStats *stats);
+void    AVLtree_statsReset(const AVLOps *ops);
+
 //----------------------------------------
 AVLTree AVLtree_search(AVLTree tree, bool (*cmp)(const void *, const void *), void *data);
+AVLTree AVLtree_search3(AVLTree tree, int (*cmp3)(const void *, const void *), const void *data);
+void    AVLtree_searchBatchOps(AVLTree tree, const AVLOps *ops, const void *const keys[], size_t count,
+                               AVLTree results[]);
+void    AVLtree_searchBatch(AVLTree tree, int (*cmp3)(const void *, const void *), const void *const keys[],
+                            size_t count, AVLTree results[]);
 
 //----------------------------------------
 AVLTree AVLtree_insertData(AVLTree tree, bool (*cmp)(const void *, const void *), const void *data, size_t size);
 AVLTree AVLtree_insertNode(AVLTree tree, bool (*cmp)(const void *, const void *), const AVLTree newNode);
+AVLTree AVLtree_insertData3(AVLTree tree, int (*cmp3)(const void *, const void *), const void *data, size_t size);
+AVLTree AVLtree_insertNode3(AVLTree tree, int (*cmp3)(const void *, const void *), const AVLTree newNode);
+AVLTree AVLtree_insertDataPool(AVLPool *pool, AVLTree tree, bool (*cmp)(const void *, const void *), const void *data, size_t size);
 
 //----------------------------------------
 AVLTree AVLtree_deleteNode(AVLTree tree, bool (*cmp) (const void *, const void *), const AVLTree node);
 AVLTree AVLtree_deleteData(AVLTree tree, bool (*cmp) (const void *, const void *), void *data);
+AVLTree AVLtree_deleteNode3(AVLTree tree, int (*cmp3)(const void *, const void *), const AVLTree node);
+AVLTree AVLtree_deleteData3(AVLTree tree, int (*cmp3)(const void *, const void *), const void *data);
 void    AVLtree_deleteTree(AVLTree *tree);
+AVLTree AVLtree_deleteNodePool(AVLPool *pool, AVLTree tree, bool (*cmp) (const void *, const void *), const AVLTree node);
+AVLTree AVLtree_deleteDataPool(AVLPool *pool, AVLTree tree, bool (*cmp) (const void *, const void *), void *data);
+void    AVLtree_deleteTreePool(AVLPool *pool, AVLTree *tree);
 
 //----------------------------------------
 void    AVLtree_pre_order(const AVLTree tree, void (*func)(void *, void *), void *extra_data);
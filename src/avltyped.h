@@ -0,0 +1,207 @@
+#ifndef _AVLTYPED_H_
+#define _AVLTYPED_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "avltree.h"
+
+
+/*
+ * Arbres AVL types, generes par macro. DEFINE_AVLTREE(name, KeyType, CMP) produit :
+ *  - une structure de noeud 'nameNode' ou la cle est un champ 'KeyType key' (pas de
+ *    'char data[]' ni de memcpy) ;
+ *  - des fonctions 'static inline' name_search, name_insert, name_delete, name_deleteTree
+ *    et name_in_order, qui suivent le meme moteur iteratif que avltree.c (chemin de liens,
+ *    remontee arretee des que la hauteur ne change plus, successeur raccroche sans copie).
+ * CMP(a, b) est une macro (ou fonction inline) a trois issues sur deux 'KeyType' : le
+ * compilateur voit donc la comparaison et peut l'integrer a la descente.
+ * A placer une fois par type, au niveau fichier :
+ *      DEFINE_AVLTREE(IntTree, int, AVLTYPED_CMP)
+ *      IntTreeNode *racine = NULL;
+ *      racine = IntTree_insert(racine, 42);
+ */
+#define AVLTYPED_CMP(a, b)      (((a) > (b)) - ((a) < (b)))
+
+#define DEFINE_AVLTREE(name, KeyType, CMP)                                                      \
+typedef struct name##Node name##Node;                                                           \
+struct          name##Node {                                                                    \
+        name##Node      *left;                                                                  \
+        name##Node      *right;                                                                 \
+        int             height;                                                                 \
+        KeyType         key;                                                                    \
+};                                                                                              \
+                                                                                                \
+static inline int name##_getHeight(const name##Node *tree) {                                    \
+    return (tree) ? tree->height : 0;                                                           \
+}                                                                                               \
+                                                                                                \
+static inline void name##_update(name##Node *tree) {                                            \
+    int left = name##_getHeight(tree->left), right = name##_getHeight(tree->right);             \
+                                                                                                \
+    tree->height = ((left > right) ? left : right) + 1;                                         \
+}                                                                                               \
+                                                                                                \
+/* Memes conventions que avltree.c : rotateLeft remonte le fils gauche. */                     \
+static inline name##Node *name##_rotateLeft(name##Node *tree) {                                 \
+    name##Node *node = tree->left;                                                              \
+                                                                                                \
+    tree->left = node->right;                                                                   \
+    node->right = tree;                                                                         \
+    name##_update(tree);                                                                        \
+    name##_update(node);                                                                        \
+    return node;                                                                                \
+}                                                                                               \
+                                                                                                \
+static inline name##Node *name##_rotateRight(name##Node *tree) {                                \
+    name##Node *node = tree->right;                                                             \
+                                                                                                \
+    tree->right = node->left;                                                                   \
+    node->left = tree;                                                                          \
+    name##_update(tree);                                                                        \
+    name##_update(node);                                                                        \
+    return node;                                                                                \
+}                                                                                               \
+                                                                                                \
+static inline name##Node *name##_rebalance(name##Node *tree) {                                  \
+    int balance = name##_getHeight(tree->left) - name##_getHeight(tree->right);                 \
+                                                                                                \
+    if (balance > 1) {                                                                          \
+        if (name##_getHeight(tree->left->left) < name##_getHeight(tree->left->right))           \
+            tree->left = name##_rotateRight(tree->left);                                        \
+        return name##_rotateLeft(tree);                                                         \
+    }                                                                                           \
+    if (balance < -1) {                                                                         \
+        if (name##_getHeight(tree->right->right) < name##_getHeight(tree->right->left))         \
+            tree->right = name##_rotateLeft(tree->right);                                       \
+        return name##_rotateRight(tree);                                                        \
+    }                                                                                           \
+    return tree;                                                                                \
+}                                                                                               \
+                                                                                                \
+static inline void name##_retrace(name##Node **path[], int level) {                             \
+    name##Node  *node;                                                                          \
+    int         oldHeight;                                                                      \
+                                                                                                \
+    for (; level >= 0; level--) {                                                               \
+        node = *path[level];                                                                    \
+        oldHeight = node->height;                                                               \
+        name##_update(node);                                                                    \
+        node = name##_rebalance(node);                                                          \
+        *path[level] = node;                                                                    \
+        if (node->height == oldHeight)                                                          \
+            break;                                                                              \
+    }                                                                                           \
+}                                                                                               \
+                                                                                                \
+static inline name##Node *name##_search(name##Node *tree, KeyType key) {                        \
+    int res;                                                                                    \
+                                                                                                \
+    while (tree && (res = CMP(key, tree->key)) != 0)                                            \
+        tree = (res < 0) ? tree->left : tree->right;                                            \
+    return tree;                                                                                \
+}                                                                                               \
+                                                                                                \
+/* Insere 'key' si elle est absente et renvoie la nouvelle racine. */                          \
+static inline name##Node *name##_insert(name##Node *tree, KeyType key) {                        \
+    name##Node  **path[AVLTREE_MAX_HEIGHT + 1];                                                 \
+    name##Node  **link = &tree;                                                                 \
+    name##Node  *node;                                                                          \
+    int         depth = 0, res;                                                                 \
+                                                                                                \
+    while ((node = *link)) {                                                                    \
+        path[depth++] = link;                                                                   \
+        if ((res = CMP(key, node->key)) == 0)                                                   \
+            return tree;                                                                        \
+        link = (res < 0) ? &node->left : &node->right;                                          \
+    }                                                                                           \
+    if (!(node = (name##Node *) malloc(sizeof(name##Node))))                                    \
+        return tree;                                                                            \
+    node->left = NULL;                                                                          \
+    node->right = NULL;                                                                         \
+    node->height = 1;                                                                           \
+    node->key = key;                                                                            \
+    *link = node;                                                                               \
+    name##_retrace(path, depth - 1);                                                            \
+    return tree;                                                                                \
+}                                                                                               \
+                                                                                                \
+/* Supprime 'key' si elle est presente et renvoie la nouvelle racine. */                       \
+static inline name##Node *name##_delete(name##Node *tree, KeyType key) {                        \
+    name##Node  **path[AVLTREE_MAX_HEIGHT + 1];                                                 \
+    name##Node  **link = &tree, **succLink;                                                     \
+    name##Node  *node, *succ;                                                                   \
+    int         depth = 0, res, level, start;                                                   \
+                                                                                                \
+    while ((node = *link)) {                                                                    \
+        path[depth++] = link;                                                                   \
+        if ((res = CMP(key, node->key)) == 0)                                                   \
+            break;                                                                              \
+        link = (res < 0) ? &node->left : &node->right;                                          \
+    }                                                                                           \
+    if (!node)                                                                                  \
+        return tree;                                                                            \
+                                                                                                \
+    level = depth - 1;                                                                          \
+    if (!node->left || !node->right) {                                                          \
+        *link = (node->left) ? node->left : node->right;                                        \
+        start = level - 1;                                                                      \
+    } else {                                                                                    \
+        start = level + 1;                                                                      \
+        succLink = &node->right;                                                                \
+        path[start] = succLink;                                                                 \
+        while ((*succLink)->left) {                                                             \
+            succLink = &(*succLink)->left;                                                      \
+            path[++start] = succLink;                                                           \
+        }                                                                                       \
+        succ = *succLink;                                                                       \
+        *succLink = succ->right;                                                                \
+        succ->left = node->left;                                                                \
+        succ->right = node->right;                                                              \
+        succ->height = node->height;                                                            \
+        *link = succ;                                                                           \
+        path[level + 1] = &succ->right;                                                         \
+        start--;                                                                                \
+    }                                                                                           \
+    name##_retrace(path, start);                                                                \
+    free(node);                                                                                 \
+    return tree;                                                                                \
+}                                                                                               \
+                                                                                                \
+/* Liberation sans pile : on fait tourner l'arbre pour remonter les fils gauches. */           \
+static inline void name##_deleteTree(name##Node **tree) {                                       \
+    name##Node *node = *tree, *oNode;                                                           \
+                                                                                                \
+    while (node) {                                                                              \
+        if (node->left) {                                                                       \
+            oNode = node->left;                                                                 \
+            node->left = oNode->right;                                                          \
+            oNode->right = node;                                                                \
+            node = oNode;                                                                       \
+        } else {                                                                                \
+            oNode = node->right;                                                                \
+            free(node);                                                                         \
+            node = oNode;                                                                       \
+        }                                                                                       \
+    }                                                                                           \
+    *tree = NULL;                                                                               \
+}                                                                                               \
+                                                                                                \
+/* Parcours infixe iteratif ; s'arrete des que 'func' renvoie false. */                        \
+static inline void name##_in_order(name##Node *tree, bool (*func)(KeyType *, void *), void *extra_data) { \
+    name##Node  *stack[AVLTREE_MAX_HEIGHT];                                                     \
+    int         depth = 0;                                                                      \
+                                                                                                \
+    while (tree || depth) {                                                                     \
+        while (tree) {                                                                          \
+            stack[depth++] = tree;                                                              \
+            tree = tree->left;                                                                  \
+        }                                                                                       \
+        tree = stack[--depth];                                                                  \
+        if (!func(&tree->key, extra_data))                                                      \
+            return;                                                                             \
+        tree = tree->right;                                                                     \
+    }                                                                                           \
+}
+
+#endif
@@ -0,0 +1,289 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+
+#include "avlworkers.h"
+
+
+/*
+ * File d'un thread : son proprietaire empile et depile en tete, les voleurs prennent en
+ * queue. Chaque file a son verrou et occupe sa propre ligne de cache.
+ */
+typedef struct AVLDeque AVLDeque;
+struct AVLDeque {
+    _Alignas(64) pthread_mutex_t lock;
+    AVLTask         *head;
+    AVLTask         *tail;
+};
+
+struct AVLWorkers {
+    pthread_mutex_t lock;
+    pthread_cond_t  wakeUp;
+    pthread_cond_t  finished;
+    atomic_size_t   pending;
+    atomic_uint     sleeping;
+    bool            stop;
+    unsigned int    nbThreads;
+    pthread_t       *threads;
+    AVLDeque        deques[];
+};
+
+typedef struct {
+    AVLWorkers      *workers;
+    unsigned int    index;
+} AVLWorkerStart;
+
+//pool et file du thread courant, s'il appartient a un pool
+static _Thread_local const AVLWorkers   *currentWorkers;
+static _Thread_local unsigned int       currentIndex;
+
+//----------------------------------------
+static void AVLdeque_push(AVLDeque *deque, AVLTask *task) {
+    pthread_mutex_lock(&deque->lock);
+    task->prev = NULL;
+    task->next = deque->head;
+    if (deque->head)
+        deque->head->prev = task;
+    else
+        deque->tail = task;
+    deque->head = task;
+    pthread_mutex_unlock(&deque->lock);
+}
+
+/*
+ * Retire la tache en tete ('newest') ou en queue de file.
+ */
+static AVLTask *AVLdeque_pop(AVLDeque *deque, bool newest) {
+    AVLTask *task;
+
+    pthread_mutex_lock(&deque->lock);
+    if ((task = (newest) ? deque->head : deque->tail)) {
+        if (task->prev)
+            task->prev->next = task->next;
+        else
+            deque->head = task->next;
+        if (task->next)
+            task->next->prev = task->prev;
+        else
+            deque->tail = task->prev;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return task;
+}
+
+//----------------------------------------
+/*
+ * Cherche une tache pour le thread de file 'self' : d'abord la plus recente de sa file,
+ * puis la plus ancienne des autres files, en partant de la suivante.
+ */
+static AVLTask *AVLworkers_find(AVLWorkers *workers, unsigned int self) {
+    AVLTask         *task;
+    unsigned int    nbDeques, offset;
+
+    if (atomic_load(&workers->pending) == 0)
+        return NULL;
+
+    task = AVLdeque_pop(&workers->deques[self], true);
+    nbDeques = workers->nbThreads + 1;
+    for (offset = 1; !task && offset < nbDeques; offset++)
+        task = AVLdeque_pop(&workers->deques[(self + offset) % nbDeques], false);
+    if (task)
+        atomic_fetch_sub(&workers->pending, 1);
+    return task;
+}
+
+/*
+ * Execute une tache puis signale sa fin a ceux qui l'attendent.
+ */
+static void AVLworkers_run(AVLWorkers *workers, AVLTask *task) {
+    task->func(task->arg);
+    pthread_mutex_lock(&workers->lock);
+    atomic_store(&task->done, 1);
+    pthread_cond_broadcast(&workers->finished);
+    pthread_mutex_unlock(&workers->lock);
+}
+
+/*
+ * Boucle des threads du pool : trouver une tache, l'executer, recommencer ; dormir quand
+ * aucune file n'a de tache.
+ */
+static void *AVLworkers_loop(void *arg) {
+    AVLWorkers      *workers = ((AVLWorkerStart *) arg)->workers;
+    unsigned int    self = ((AVLWorkerStart *) arg)->index;
+    AVLTask         *task;
+
+    free(arg);
+    currentWorkers = workers;
+    currentIndex = self;
+
+    for (;;) {
+        if ((task = AVLworkers_find(workers, self))) {
+            AVLworkers_run(workers, task);
+            continue;
+        }
+        pthread_mutex_lock(&workers->lock);
+        atomic_fetch_add(&workers->sleeping, 1);
+        while (!workers->stop && atomic_load(&workers->pending) == 0)
+            pthread_cond_wait(&workers->wakeUp, &workers->lock);
+        atomic_fetch_sub(&workers->sleeping, 1);
+        if (workers->stop) {
+            pthread_mutex_unlock(&workers->lock);
+            return NULL;
+        }
+        pthread_mutex_unlock(&workers->lock);
+    }
+}
+
+//----------------------------------------
+/*
+ * Cree un pool de 'nbThreads' threads. Le thread appelant participe aussi au travail
+ * lors des #AVLworkers_join(), il est donc raisonnable de demander nbCoeurs - 1 threads.
+ * Renvoie NULL si 'nbThreads' vaut 0 ou en cas d'echec.
+ */
+AVLWorkers      *AVLworkers_create(unsigned int nbThreads) {
+    AVLWorkers      *workers;
+    AVLWorkerStart  *start;
+    unsigned int    index;
+
+    if (nbThreads == 0)
+        return NULL;
+    workers = (AVLWorkers *) aligned_alloc(64, (sizeof(AVLWorkers) + sizeof(AVLDeque) * (nbThreads + 1) + 63) / 64 * 64);
+    if (!workers)
+        return NULL;
+    if (!(workers->threads = (pthread_t *) malloc(sizeof(pthread_t) * nbThreads))) {
+        free(workers);
+        return NULL;
+    }
+
+    pthread_mutex_init(&workers->lock, NULL);
+    pthread_cond_init(&workers->wakeUp, NULL);
+    pthread_cond_init(&workers->finished, NULL);
+    atomic_init(&workers->pending, 0);
+    atomic_init(&workers->sleeping, 0);
+    workers->stop = false;
+    workers->nbThreads = 0;
+    for (index = 0; index <= nbThreads; index++) {
+        pthread_mutex_init(&workers->deques[index].lock, NULL);
+        workers->deques[index].head = NULL;
+        workers->deques[index].tail = NULL;
+    }
+
+    //les files des threads du pool (1 a nbThreads) existent avant le premier vol
+    workers->nbThreads = nbThreads;
+    for (index = 0; index < nbThreads; index++) {
+        if (!(start = (AVLWorkerStart *) malloc(sizeof(AVLWorkerStart))))
+            break;
+        *start = (AVLWorkerStart) { workers, index + 1 };
+        if (pthread_create(&workers->threads[index], NULL, AVLworkers_loop, start) != 0) {
+            free(start);
+            break;
+        }
+    }
+    if (index < nbThreads) {
+        //les threads deja lances volent dans toutes les files : on les arrete avant de liberer
+        pthread_mutex_lock(&workers->lock);
+        workers->stop = true;
+        pthread_cond_broadcast(&workers->wakeUp);
+        pthread_mutex_unlock(&workers->lock);
+        workers->nbThreads = index;
+        AVLworkers_destroy(workers);
+        return NULL;
+    }
+    return workers;
+}
+
+/*
+ * Arrete les threads du pool et libere le pool. Les taches doivent etre terminees.
+ */
+void            AVLworkers_destroy(AVLWorkers *workers) {
+    unsigned int index;
+
+    if (!workers)
+        return;
+
+    pthread_mutex_lock(&workers->lock);
+    workers->stop = true;
+    pthread_cond_broadcast(&workers->wakeUp);
+    pthread_mutex_unlock(&workers->lock);
+
+    for (index = 0; index < workers->nbThreads; index++)
+        pthread_join(workers->threads[index], NULL);
+
+    for (index = 0; index <= workers->nbThreads; index++)
+        pthread_mutex_destroy(&workers->deques[index].lock);
+    pthread_cond_destroy(&workers->finished);
+    pthread_cond_destroy(&workers->wakeUp);
+    pthread_mutex_destroy(&workers->lock);
+    free(workers->threads);
+    free(workers);
+}
+
+/*
+ * Renvoie le nombre de threads du pool (0 pour un pool nul).
+ */
+unsigned int    AVLworkers_getSize(const AVLWorkers *workers) {
+    if (workers)
+        return workers->nbThreads;
+    return 0;
+}
+
+/*
+ * Renvoie l'indice de la file du thread appelant : de 1 a #AVLworkers_getSize() pour un
+ * thread du pool, 0 pour tout autre thread. Une tache s'execute en entier sur le meme
+ * thread : l'indice peut servir a tenir des resultats partiels par thread.
+ */
+unsigned int    AVLworkers_getIndex(const AVLWorkers *workers) {
+    if (workers && currentWorkers == workers)
+        return currentIndex;
+    return 0;
+}
+
+//----------------------------------------
+/*
+ * Confie 'func(arg)' au pool. Sans pool, la tache est executee immediatement.
+ * 'task' doit rester valide jusqu'au #AVLworkers_join() correspondant.
+ */
+void    AVLworkers_fork(AVLWorkers *workers, AVLTask *task, void (*func)(void *), void *arg) {
+    task->func = func;
+    task->arg = arg;
+    atomic_init(&task->done, 0);
+
+    if (!workers) {
+        func(arg);
+        atomic_store(&task->done, 1);
+        return;
+    }
+
+    AVLdeque_push(&workers->deques[AVLworkers_getIndex(workers)], task);
+    atomic_fetch_add(&workers->pending, 1);
+    if (atomic_load(&workers->sleeping) > 0) {
+        pthread_mutex_lock(&workers->lock);
+        pthread_cond_signal(&workers->wakeUp);
+        pthread_mutex_unlock(&workers->lock);
+    }
+}
+
+/*
+ * Attend la fin de 'task'. En attendant, le thread appelant execute d'autres taches (en
+ * commencant par la plus recente de sa file, souvent 'task' elle-meme, puis en volant),
+ * ce qui evite tout interblocage lorsque des taches attendent leurs propres sous-taches.
+ */
+void    AVLworkers_join(AVLWorkers *workers, AVLTask *task) {
+    AVLTask         *other;
+    unsigned int    self;
+
+    if (!workers)
+        return;
+
+    self = AVLworkers_getIndex(workers);
+    while (!atomic_load(&task->done)) {
+        if ((other = AVLworkers_find(workers, self))) {
+            AVLworkers_run(workers, other);
+            continue;
+        }
+        pthread_mutex_lock(&workers->lock);
+        while (!atomic_load(&task->done) && atomic_load(&workers->pending) == 0)
+            pthread_cond_wait(&workers->finished, &workers->lock);
+        pthread_mutex_unlock(&workers->lock);
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef _AVLWORKERS_H_
+#define _AVLWORKERS_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+
+/*
+ * Pool de threads 'fork-join' a vol de taches, utilise par les operations paralleles sur
+ * les arbres.
+ * Une tache est decrite par une structure 'AVLTask' fournie par l'appelant (en general sur
+ * sa pile) : #AVLworkers_fork() la place dans la file du thread appelant, #AVLworkers_join()
+ * attend sa fin en executant d'autres taches plutot que de bloquer.
+ * Chaque thread du pool a sa propre file : il y prend la tache la plus recente (la plus
+ * petite, encore chaude dans son cache) et, quand elle est vide, vole la plus ancienne
+ * (la plus grosse) de la file d'un autre thread. Les threads exterieurs au pool partagent
+ * une file commune, d'indice 0.
+ */
+typedef struct AVLWorkers AVLWorkers;
+typedef struct AVLTask    AVLTask;
+struct          AVLTask {
+        void    (*func)(void *);
+        void    *arg;
+        AVLTask *next;
+        AVLTask *prev;
+        atomic_int      done;
+};
+
+/*--------------------------------------------------------------------*/
+AVLWorkers      *AVLworkers_create(unsigned int nbThreads);
+void            AVLworkers_destroy(AVLWorkers *workers);
+unsigned int    AVLworkers_getSize(const AVLWorkers *workers);
+unsigned int    AVLworkers_getIndex(const AVLWorkers *workers);
+
+//----------------------------------------
+void    AVLworkers_fork(AVLWorkers *workers, AVLTask *task, void (*func)(void *), void *arg);
+void    AVLworkers_join(AVLWorkers *workers, AVLTask *task);
+/*--------------------------------------------------------------------*/
+
+#endif
@@ -1,9 +1,32 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <string.h>
 #include <assert.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
 #include "time.h"
 
 #include "avltree.h"
+#include "avlpool.h"
+#include "avlcursor.h"
+#include "avlsetops.h"
+#include "avlconcurrent.h"
+#include "avlpersist.h"
+#include "avlfrozen.h"
+#include "avltyped.h"
+#include "avlcompact.h"
+#include "avlkv.h"
+#include "avlhandle.h"
+#include "avlmapped.h"
+#include "avlparallel.h"
+#include "avlreclaim.h"
+#include "avlmultiset.h"
+#include "avlsharded.h"
+#include "avlinterval.h"
 
 void display_avl(AVLTree node) {
     if (!node)
@@ -24,6 +47,16 @@ bool    compare(const void * a, const void * b) {
     return *(int*)a < *(int*)b;
 }
 
+int     compare3(const void * a, const void * b) {
+    return (*(int*)a > *(int*)b) - (*(int*)a < *(int*)b);
+}
+
+int     nbCompare3 = 0;
+int     countCompare3(const void * a, const void * b) {
+    nbCompare3++;
+    return compare3(a, b);
+}
+
 void    monPrintF(void * a, void * b) {
     printf("Valeur du noeud : %d\n", *(int*)a);
 }
@@ -200,8 +233,1740 @@ void    testArbresAVL(void){
     printf("PASS -> AVLtree_deleteTree\n");
 }
 
+/**
+ * Tests de l'allocateur par slabs : insertion et suppression dans un pool
+ * puis liberation en bloc de l'arbre.
+ */
+void    testPoolAVL(void){
+    AVLPool pool;
+    AVLTree racine = AVLtree_new();
+    int     value;
+
+    assert(AVLtree_nodeSize(sizeof(int)) >= sizeof(struct AVLTreeNode));
+    assert(AVLpool_init(&pool, sizeof(int), 4));
+    for (value = 0; value < 100; value++)
+        racine = AVLtree_insertDataPool(&pool, racine, compare, &value, sizeof(int));
+    assert(100 == AVLtree_size_basedToNode(racine));
+    assert(100 == AVLpool_getSize(&pool));
+    printf("PASS -> AVLtree_insertDataPool\n");
+
+    for (value = 99; value >= 50; value--)
+        racine = AVLtree_deleteDataPool(&pool, racine, compare, &value);
+    assert(50 == AVLtree_size_basedToNode(racine));
+    assert(50 == AVLpool_getSize(&pool));
+    assert(49 == *(int*)AVLtree_getMAX(racine)->data);
+    printf("PASS -> AVLtree_deleteDataPool\n");
+
+    //les noeuds liberes sont reutilises avant d'allouer un nouveau slab
+    value = 1000;
+    racine = AVLtree_insertDataPool(&pool, racine, compare, &value, sizeof(int));
+    assert(1000 == *(int*)AVLtree_getMAX(racine)->data);
+    assert(NULL == AVLtree_createPool(&pool, &value, sizeof(int) * 2));
+
+    AVLtree_deleteTreePool(&pool, &racine);
+    assert(NULL == racine);
+    assert(0 == AVLpool_getSize(&pool));
+    printf("PASS -> AVLtree_deleteTreePool\n");
+}
+
+/**
+ * Tests de l'API a comparateur a trois issues.
+ * On verifie au passage qu'une recherche ne coute qu'une comparaison par niveau.
+ */
+void    testCompare3AVL(void){
+    AVLTree racine = AVLtree_new();
+    int     value;
+
+    for (value = 0; value < 64; value++) {
+        int key = (value * 37) % 64;
+        racine = AVLtree_insertData3(racine, compare3, &key, sizeof(int));
+    }
+    assert(64 == AVLtree_size_basedToNode(racine));
+    assert(0 == *(int*)AVLtree_getMIN(racine)->data);
+    assert(63 == *(int*)AVLtree_getMAX(racine)->data);
+    printf("PASS -> AVLtree_insertData3\n");
+
+    value = 17;
+    nbCompare3 = 0;
+    assert(17 == *(int*)AVLtree_search3(racine, countCompare3, &value)->data);
+    assert(nbCompare3 <= (int) AVLtree_getHeight(racine));
+    value = 100;
+    assert(NULL == AVLtree_search3(racine, compare3, &value));
+    printf("PASS -> AVLtree_search3\n");
+
+    for (value = 0; value < 64; value += 3)
+        racine = AVLtree_deleteData3(racine, compare3, &value);
+    assert(42 == AVLtree_size_basedToNode(racine));
+    value = 3;
+    assert(NULL == AVLtree_search3(racine, compare3, &value));
+    value = 4;
+    assert(4 == *(int*)AVLtree_search3(racine, compare3, &value)->data);
+    racine = AVLtree_deleteNode3(racine, compare3, racine);
+    assert(41 == AVLtree_size_basedToNode(racine));
+    printf("PASS -> AVLtree_deleteData3\n");
+
+    AVLtree_deleteTree(&racine);
+}
+
+/**
+ * Verifie recursivement qu'un arbre est un AVL valide : ordre des cles, champ 'height'
+ * a jour et ecart de hauteur d'au plus un. Renvoie la hauteur reelle.
+ */
+int     checkAVL(AVLTree node, int *min, int *max) {
+    int hl, hr;
+
+    if (!node)
+        return 0;
+    if (min)
+        assert(*min < *(int*)node->data);
+    if (max)
+        assert(*(int*)node->data < *max);
+    hl = checkAVL(node->left, min, (int*)node->data);
+    hr = checkAVL(node->right, (int*)node->data, max);
+    assert(hl - hr <= 1 && hr - hl <= 1);
+    assert(node->height == 1 + (hl > hr ? hl : hr));
+    assert(AVLtree_getSize(node) == AVLtree_size_basedToNode(node));
+    return node->height;
+}
+
+/**
+ * Tests du moteur iteratif : insertions et suppressions aleatoires comparees a un
+ * tableau de presence, avec verification de l'equilibre apres chaque operation.
+ */
+void    testIterativeAVL(void){
+    AVLOps  ops = { .cmp3 = compare3 };
+    AVLPath path;
+    AVLTree racine = AVLtree_new();
+    bool    present[512] = { false };
+    int     index, value, nbPresent = 0;
+
+    for (index = 0; index < 4000; index++) {
+        value = rand() % 512;
+        if (rand() % 3) {
+            racine = AVLtree_insertOps(racine, &ops, &value, sizeof(int));
+            nbPresent += !present[value];
+            present[value] = true;
+        } else {
+            racine = AVLtree_deleteOps(racine, &ops, &value);
+            nbPresent -= present[value];
+            present[value] = false;
+        }
+        checkAVL(racine, NULL, NULL);
+    }
+    assert(nbPresent == (int) AVLtree_size_basedToNode(racine));
+    for (value = 0; value < 512; value++)
+        assert(present[value] == (AVLtree_search3(racine, compare3, &value) != NULL));
+    printf("PASS -> AVLtree_insertOps / AVLtree_deleteOps\n");
+
+    //le chemin memorise permet de decrocher le noeud sans le liberer
+    value = *(int*)racine->data;
+    assert(AVLtree_pathFind(&racine, &ops, &value, &path));
+    AVLTree node = AVLtree_pathRemove(&path, &ops);
+    assert(value == *(int*)node->data);
+    assert(NULL == AVLtree_search3(racine, compare3, &value));
+    checkAVL(racine, NULL, NULL);
+    assert(!AVLtree_pathFind(&racine, &ops, &value, &path));
+    AVLtree_pathInsert(&path, &ops, node);
+    assert(node == AVLtree_search3(racine, compare3, &value));
+    checkAVL(racine, NULL, NULL);
+    printf("PASS -> AVLtree_pathFind / pathRemove / pathInsert\n");
+
+    //un arbre degenere ne fait pas deborder les fonctions iteratives
+    AVLtree_deleteTree(&racine);
+    for (value = 0; value < 100000; value++) {
+        node = AVLtree_create(&value, sizeof(int));
+        node->left = racine;
+        racine = node;
+    }
+    assert(100000 == AVLtree_size_basedToNode(racine));
+    assert(100000 == AVLtree_height_basedToNode(racine));
+    AVLtree_deleteTree(&racine);
+    assert(NULL == racine);
+    printf("PASS -> AVLtree_deleteTree (iteratif)\n");
+}
+
+/**
+ * Tests de l'augmentation statistique d'ordre : taille, rang et selection.
+ */
+void    testOrderStatisticAVL(void){
+    AVLTree racine = AVLtree_new();
+    int     value;
+
+    for (value = 0; value < 200; value++) {
+        int key = value * 2;
+        racine = AVLtree_insertData3(racine, compare3, &key, sizeof(int));
+    }
+    for (value = 0; value < 200; value += 4)
+        racine = AVLtree_deleteData3(racine, compare3, &(int){ value * 2 });
+    checkAVL(racine, NULL, NULL);
+    assert(150 == AVLtree_getSize(racine));
+    printf("PASS -> AVLtree_getSize\n");
+
+    //cles restantes : 2, 4, 6, 10, 12, 14, 18...
+    assert(0 == AVLtree_rank(racine, compare3, &(int){ 0 }));
+    assert(0 == AVLtree_rank(racine, compare3, &(int){ 2 }));
+    assert(3 == AVLtree_rank(racine, compare3, &(int){ 8 }));
+    assert(3 == AVLtree_rank(racine, compare3, &(int){ 10 }));
+    assert(150 == AVLtree_rank(racine, compare3, &(int){ 1000 }));
+    printf("PASS -> AVLtree_rank\n");
+
+    assert(2 == *(int*)AVLtree_select(racine, 0)->data);
+    assert(10 == *(int*)AVLtree_select(racine, 3)->data);
+    assert(398 == *(int*)AVLtree_select(racine, 149)->data);
+    assert(NULL == AVLtree_select(racine, 150));
+    for (value = 0; value < 150; value++)
+        assert(value == (int) AVLtree_rank(racine, compare3, AVLtree_select(racine, value)->data));
+    printf("PASS -> AVLtree_select\n");
+
+    AVLtree_deleteTree(&racine);
+}
+
+bool    sumUntil(void * a, void * b) {
+    int *acc = (int*)b;
+
+    acc[0] += *(int*)a;
+    return ++acc[1] < acc[2];
+}
+
+/**
+ * Tests du curseur ordonne et des parcours d'intervalle.
+ */
+void    testCursorAVL(void){
+    AVLTree     racine = AVLtree_new();
+    AVLCursor   cursor;
+    int         value;
+
+    //cles paires de 0 a 98
+    for (value = 0; value < 100; value += 2)
+        racine = AVLtree_insertData3(racine, compare3, &value, sizeof(int));
+
+    AVLcursor_init(&cursor, racine);
+    assert(!AVLcursor_valid(&cursor));
+    assert(AVLcursor_first(&cursor));
+    for (value = 0; AVLcursor_valid(&cursor); AVLcursor_next(&cursor), value += 2)
+        assert(value == *(int*)AVLcursor_getData(&cursor));
+    assert(100 == value);
+    assert(AVLcursor_last(&cursor));
+    for (value = 98; AVLcursor_valid(&cursor); AVLcursor_prev(&cursor), value -= 2)
+        assert(value == *(int*)AVLcursor_getData(&cursor));
+    printf("PASS -> AVLcursor_next / AVLcursor_prev\n");
+
+    assert(AVLcursor_seek(&cursor, compare3, &(int){ 40 }));
+    assert(40 == *(int*)AVLcursor_getData(&cursor));
+    assert(!AVLcursor_seek(&cursor, compare3, &(int){ 41 }));
+    assert(AVLcursor_lowerBound(&cursor, compare3, &(int){ 41 }));
+    assert(42 == *(int*)AVLcursor_getData(&cursor));
+    assert(AVLcursor_lowerBound(&cursor, compare3, &(int){ 42 }));
+    assert(42 == *(int*)AVLcursor_getData(&cursor));
+    assert(AVLcursor_upperBound(&cursor, compare3, &(int){ 42 }));
+    assert(44 == *(int*)AVLcursor_getData(&cursor));
+    assert(AVLcursor_prev(&cursor) && AVLcursor_prev(&cursor));
+    assert(40 == *(int*)AVLcursor_getData(&cursor));
+    assert(!AVLcursor_upperBound(&cursor, compare3, &(int){ 98 }));
+    printf("PASS -> AVLcursor_seek / lowerBound / upperBound\n");
+
+    //[10, 20) : 10 + 12 + 14 + 16 + 18, puis arret anticipe apres deux elements
+    int acc[3] = { 0, 0, 100 };
+    assert(5 == AVLtree_range(racine, compare3, &(int){ 10 }, &(int){ 20 }, sumUntil, acc));
+    assert(70 == acc[0]);
+    acc[0] = 0; acc[1] = 0; acc[2] = 2;
+    assert(2 == AVLtree_range(racine, compare3, &(int){ 9 }, NULL, sumUntil, acc));
+    assert(22 == acc[0]);
+    printf("PASS -> AVLtree_range\n");
+
+    AVLtree_deleteTree(&racine);
+}
+
+/**
+ * Tests de la construction en bloc a partir de donnees triees ou non.
+ */
+void    testBuildAVL(void){
+    AVLTree racine;
+    int     sorted[1000];
+    int     unsorted[12] = { 5, 3, 9, 3, 1, 12, 5, 7, 0, 9, 11, 2 };
+    int     value;
+
+    for (value = 0; value < 1000; value++)
+        sorted[value] = value * 3;
+    racine = AVLtree_buildFromSorted(sorted, 1000, sizeof(int));
+    checkAVL(racine, NULL, NULL);
+    assert(1000 == AVLtree_getSize(racine));
+    assert(10 == AVLtree_getHeight(racine));
+    assert(2997 == *(int*)AVLtree_getMAX(racine)->data);
+    assert(NULL != AVLtree_search3(racine, compare3, &(int){ 300 }));
+    //l'arbre construit reste un AVL modifiable normalement
+    racine = AVLtree_insertData3(racine, compare3, &(int){ 1 }, sizeof(int));
+    racine = AVLtree_deleteData3(racine, compare3, &(int){ 300 });
+    checkAVL(racine, NULL, NULL);
+    AVLtree_deleteTree(&racine);
+    assert(NULL == AVLtree_buildFromSorted(sorted, 0, sizeof(int)));
+    printf("PASS -> AVLtree_buildFromSorted\n");
+
+    racine = AVLtree_buildFromUnsorted(unsorted, 12, sizeof(int), compare3);
+    checkAVL(racine, NULL, NULL);
+    assert(9 == AVLtree_getSize(racine));
+    assert(0 == *(int*)AVLtree_select(racine, 0)->data);
+    assert(12 == *(int*)AVLtree_select(racine, 8)->data);
+    AVLtree_deleteTree(&racine);
+    printf("PASS -> AVLtree_buildFromUnsorted\n");
+}
+
+/**
+ * Construit l'arbre des multiples de 'step' dans [0, limit).
+ */
+AVLTree multiplesTree(int step, int limit) {
+    static int  values[40000];
+    int         count;
+
+    for (count = 0; count * step < limit; count++)
+        values[count] = count * step;
+    return AVLtree_buildFromSorted(values, count, sizeof(int));
+}
+
+/**
+ * Tests des jointures, coupes et operations ensemblistes, en sequentiel puis sur
+ * plusieurs threads.
+ */
+void    testSetOpsAVL(void){
+    AVLOps          ops = { .cmp3 = compare3 };
+    AVLTree         racine, left, right, found, middle;
+    unsigned int    nbThreads;
+
+    racine = multiplesTree(1, 1000);
+    found = AVLtree_split(racine, &ops, &(int){ 300 }, &left, &right);
+    assert(300 == *(int*)found->data);
+    checkAVL(left, NULL, NULL);
+    checkAVL(right, NULL, NULL);
+    assert(300 == AVLtree_getSize(left));
+    assert(699 == AVLtree_getSize(right));
+    racine = AVLtree_join(left, found, right);
+    checkAVL(racine, NULL, NULL);
+    assert(1000 == AVLtree_getSize(racine));
+    printf("PASS -> AVLtree_split / AVLtree_join\n");
+
+    middle = AVLtree_splitRange(racine, &ops, &(int){ 100 }, &(int){ 250 }, &left, &right);
+    checkAVL(middle, NULL, NULL);
+    assert(150 == AVLtree_getSize(middle));
+    assert(100 == *(int*)AVLtree_getMIN(middle)->data);
+    assert(249 == *(int*)AVLtree_getMAX(middle)->data);
+    racine = AVLtree_join2(AVLtree_join2(left, middle), right);
+    checkAVL(racine, NULL, NULL);
+    assert(1000 == AVLtree_getSize(racine));
+    AVLtree_deleteTree(&racine);
+    printf("PASS -> AVLtree_splitRange / AVLtree_join2\n");
+
+    for (nbThreads = 1; nbThreads <= 4; nbThreads *= 4) {
+        //multiples de 2 et de 3 dans [0, 60000)
+        racine = AVLtree_union(multiplesTree(2, 60000), multiplesTree(3, 60000), &ops, nbThreads);
+        checkAVL(racine, NULL, NULL);
+        assert(40000 == AVLtree_getSize(racine));
+        AVLtree_deleteTree(&racine);
+
+        racine = AVLtree_intersection(multiplesTree(2, 60000), multiplesTree(3, 60000), &ops, nbThreads);
+        checkAVL(racine, NULL, NULL);
+        assert(10000 == AVLtree_getSize(racine));
+        assert(6 == *(int*)AVLtree_select(racine, 1)->data);
+        AVLtree_deleteTree(&racine);
+
+        racine = AVLtree_difference(multiplesTree(2, 60000), multiplesTree(3, 60000), &ops, nbThreads);
+        checkAVL(racine, NULL, NULL);
+        assert(20000 == AVLtree_getSize(racine));
+        assert(NULL == AVLtree_search3(racine, compare3, &(int){ 6 }));
+        AVLtree_deleteTree(&racine);
+    }
+    printf("PASS -> AVLtree_union / intersection / difference\n");
+}
+
+/**
+ * Tests des insertions et suppressions par lots, en sequentiel puis sur plusieurs threads,
+ * comparees a un tableau de presence. Les lots contiennent des doublons et des donnees
+ * deja presentes (ou absentes pour la suppression).
+ */
+void    testBatchAVL(void){
+    static int      batch[20000];
+    static bool     present[60000];
+    AVLOps          ops = { .cmp3 = compare3 };
+    AVLTree         racine;
+    unsigned int    nbThreads;
+    int             index, value, nbPresent;
+
+    for (nbThreads = 1; nbThreads <= 4; nbThreads *= 4) {
+        racine = multiplesTree(2, 60000);
+        for (value = 0; value < 60000; value++)
+            present[value] = !(value % 2);
+        nbPresent = 30000;
+
+        for (index = 0; index < 20000; index++) {
+            batch[index] = value = rand() % 60000;
+            nbPresent += !present[value];
+            present[value] = true;
+        }
+        racine = AVLtree_insertBatch(racine, &ops, batch, 20000, sizeof(int), nbThreads);
+        checkAVL(racine, NULL, NULL);
+        assert(nbPresent == (int) AVLtree_getSize(racine));
+
+        for (index = 0; index < 20000; index++) {
+            batch[index] = value = rand() % 60000;
+            nbPresent -= present[value];
+            present[value] = false;
+        }
+        racine = AVLtree_deleteBatch(racine, &ops, batch, 20000, sizeof(int), nbThreads);
+        checkAVL(racine, NULL, NULL);
+        assert(nbPresent == (int) AVLtree_getSize(racine));
+        for (value = 0; value < 60000; value++)
+            assert(present[value] == (AVLtree_search3(racine, compare3, &value) != NULL));
+        AVLtree_deleteTree(&racine);
+    }
+
+    //lot insere dans un arbre vide : construit directement
+    for (index = 0; index < 100; index++)
+        batch[index] = 99 - index;
+    racine = AVLtree_insertBatch(NULL, &ops, batch, 100, sizeof(int), 1);
+    checkAVL(racine, NULL, NULL);
+    assert(100 == AVLtree_getSize(racine));
+    racine = AVLtree_deleteBatch(racine, &ops, batch, 100, sizeof(int), 1);
+    assert(!racine);
+    printf("PASS -> AVLtree_insertBatch / AVLtree_deleteBatch\n");
+}
+
+double  nowSeconds(void) {
+    struct timespec ts;
+
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+typedef struct ConcurrentArgs {
+    AVLConcurrent   *tree;
+    atomic_bool     *stop;
+    unsigned long   nbOps;
+    unsigned int    seed;
+} ConcurrentArgs;
+
+/*
+ * Lecteur : les cles paires ne sont jamais retirees et doivent toujours etre trouvees.
+ */
+void    *concurrentReader(void *arg) {
+    ConcurrentArgs  *args = (ConcurrentArgs*)arg;
+    AVLReader       *reader = AVLconcurrent_registerReader(args->tree);
+    int             key, found;
+
+    assert(reader);
+    while (!atomic_load(args->stop)) {
+        key = rand_r(&args->seed) % 20000;
+        if (AVLconcurrent_search(args->tree, reader, &key, &found))
+            assert(found == key);
+        else
+            assert(key % 2);
+        args->nbOps++;
+    }
+    AVLconcurrent_unregisterReader(reader);
+    return NULL;
+}
+
+/*
+ * Ecrivain : insere et retire des cles impaires en continu.
+ */
+void    *concurrentWriter(void *arg) {
+    ConcurrentArgs  *args = (ConcurrentArgs*)arg;
+    int             key;
+
+    while (!atomic_load(args->stop)) {
+        key = (rand_r(&args->seed) % 10000) * 2 + 1;
+        if (!AVLconcurrent_insert(args->tree, &key))
+            AVLconcurrent_delete(args->tree, &key);
+        args->nbOps++;
+    }
+    return NULL;
+}
+
+/**
+ * Test de l'arbre concurrent : des lecteurs sans verrou face a un ecrivain, avec mesure
+ * du debit de lecture selon le nombre de lecteurs.
+ */
+void    testConcurrentAVL(void){
+    AVLConcurrent   tree;
+    ConcurrentArgs  args[9];
+    pthread_t       threads[9];
+    atomic_bool     stop;
+    unsigned int    nbReaders, index;
+    unsigned long   nbReads;
+    double          start, elapsed;
+    int             key;
+
+    assert(AVLconcurrent_init(&tree, compare3, sizeof(int)));
+    for (key = 0; key < 20000; key += 2)
+        assert(AVLconcurrent_insert(&tree, &key));
+    assert(!AVLconcurrent_insert(&tree, &(int){ 0 }));
+
+    for (nbReaders = 1; nbReaders <= 8; nbReaders *= 2) {
+        atomic_init(&stop, false);
+        for (index = 0; index <= nbReaders; index++) {
+            args[index] = (ConcurrentArgs) { &tree, &stop, 0, index + 1 };
+            pthread_create(&threads[index], NULL, (index == 0) ? concurrentWriter : concurrentReader, &args[index]);
+        }
+        start = nowSeconds();
+        while (nowSeconds() - start < 0.1)
+            ;
+        atomic_store(&stop, true);
+        nbReads = 0;
+        for (index = 0; index <= nbReaders; index++) {
+            pthread_join(threads[index], NULL);
+            if (index)
+                nbReads += args[index].nbOps;
+        }
+        elapsed = nowSeconds() - start;
+        printf("%u lecteur(s) : %.0f recherches/s, %.0f ecritures/s\n", nbReaders, nbReads / elapsed, args[0].nbOps / elapsed);
+    }
+
+    AVLReader *reader = AVLconcurrent_registerReader(&tree);
+    checkAVL(AVLconcurrent_readBegin(&tree, reader), NULL, NULL);
+    AVLconcurrent_readEnd(reader);
+    AVLconcurrent_unregisterReader(reader);
+    AVLconcurrent_destroy(&tree);
+    printf("PASS -> AVLconcurrent\n");
+}
+
+/**
+ * Tests de l'arbre persistant : les versions retenues ne voient pas les ecritures
+ * suivantes et les noeuds partages sont liberes avec la derniere version.
+ */
+void    testPersistentAVL(void){
+    AVLPersistent   tree;
+    AVLTree         snapshot1, snapshot2;
+    int             key;
+
+    assert(AVLpersist_init(&tree, compare3, sizeof(int)));
+    for (key = 0; key < 100; key++)
+        assert(AVLpersist_insert(&tree, &key));
+    assert(!AVLpersist_insert(&tree, &(int){ 5 }));
+    assert(100 == AVLpersist_getNbNodes(&tree));
+
+    snapshot1 = AVLpersist_snapshot(&tree);
+    for (key = 0; key < 100; key += 2)
+        assert(AVLpersist_delete(&tree, &key));
+    for (key = 100; key < 150; key++)
+        assert(AVLpersist_insert(&tree, &key));
+    snapshot2 = AVLpersist_snapshot(&tree);
+    assert(AVLpersist_insert(&tree, &(int){ 1000 }));
+
+    checkAVL(snapshot1, NULL, NULL);
+    checkAVL(snapshot2, NULL, NULL);
+    checkAVL(tree.root, NULL, NULL);
+    assert(100 == AVLtree_getSize(snapshot1));
+    assert(NULL != AVLtree_search3(snapshot1, compare3, &(int){ 4 }));
+    assert(NULL == AVLtree_search3(snapshot1, compare3, &(int){ 120 }));
+    assert(100 == AVLtree_getSize(snapshot2));
+    assert(NULL == AVLtree_search3(snapshot2, compare3, &(int){ 4 }));
+    assert(NULL == AVLtree_search3(snapshot2, compare3, &(int){ 1000 }));
+    assert(101 == AVLtree_getSize(tree.root));
+    //les versions partagent leurs noeuds : bien moins que 100 + 100 + 101
+    assert(AVLpersist_getNbNodes(&tree) < 250);
+    printf("PASS -> AVLpersist_snapshot\n");
+
+    AVLpersist_release(&tree, snapshot1);
+    AVLpersist_release(&tree, snapshot2);
+    assert(101 == AVLpersist_getNbNodes(&tree));
+    AVLpersist_destroy(&tree);
+    assert(0 == AVLpersist_getNbNodes(&tree));
+    printf("PASS -> AVLpersist_release\n");
+}
+
+/**
+ * Tests de la copie figee : recherche scalaire, borne inferieure et recherche par lots
+ * (noyau SIMD) doivent donner les memes resultats, pour des tailles qui remplissent ou non
+ * le dernier niveau. Les donnees sont des paires (cle, valeur), seule la cle est copiee
+ * dans le tableau des cles.
+ */
+void    testFrozenAVL(void){
+    static int  pairs[5000][2];
+    static int  keys[10002];
+    static void *results[10002];
+    AVLFrozen   frozen;
+    AVLTree     racine;
+    int         sizes[] = { 0, 1, 2, 3, 7, 8, 9, 31, 33, 100, 5000 };
+    int         s, size, key;
+    int         *found;
+
+    for (s = 0; s < (int) (sizeof(sizes) / sizeof(sizes[0])); s++) {
+        size = sizes[s];
+        for (key = 0; key < size; key++) {
+            pairs[key][0] = 2 * key;
+            pairs[key][1] = key;
+        }
+        racine = AVLtree_buildFromSorted(pairs, size, sizeof(pairs[0]));
+        assert(AVLtree_freeze(racine, &frozen, sizeof(pairs[0]), sizeof(int), compare3));
+        AVLtree_deleteTree(&racine);
+        assert((size_t) size == AVLfrozen_getSize(&frozen));
+
+        for (key = -1; key <= 2 * size; key++) {
+            found = (int *) AVLfrozen_search(&frozen, &key);
+            assert(found == AVLfrozen_searchInt(&frozen, key));
+            if (key >= 0 && key < 2 * size && !(key % 2))
+                assert(found && found[0] == key && found[1] == key / 2);
+            else
+                assert(!found);
+            found = (int *) AVLfrozen_lowerBound(&frozen, &key);
+            if (key < 2 * size - 1)
+                assert(found && found[0] == key + (key & 1));
+            else
+                assert(!found);
+            keys[key + 1] = key;
+        }
+        AVLfrozen_searchIntBatch(&frozen, keys, 2 * size + 2, results);
+        for (key = -1; key <= 2 * size; key++)
+            assert(results[key + 1] == AVLfrozen_searchInt(&frozen, key));
+        AVLfrozen_destroy(&frozen);
+    }
+    printf("PASS -> AVLtree_freeze\n");
+}
+
+/**
+ * Tests de l'instrumentation. Compilee avec -DAVLTREE_STATS=1 (make STATS=y), on verifie
+ * les compteurs sur des sequences dont on connait les rotations ; sinon AVLtree_stats
+ * doit signaler que les compteurs sont absents.
+ */
+void    testStatsAVL(void){
+    AVLStats    stats;
+    AVLTree     racine = NULL;
+    int         values[] = { 1, 2, 3, 4, 5, 6, 7, 30, 10, 20 };
+    int         index;
+#if AVLTREE_STATS
+    AVLStats    counters;
+    AVLOps      ops = { .cmp3 = compare3, .stats = &counters };
+    AVLTree     other;
+    static int  evens[30000], thirds[20000];
+    unsigned long total;
+
+    AVLtree_statsReset(&ops);
+    //1..7 dans l'ordre : 4 rotations simples ; 10 sous 30 : une double, puis 20 : une simple
+    for (index = 0; index < 10; index++)
+        racine = AVLtree_insertOps(racine, &ops, &values[index], sizeof(int));
+    racine = AVLtree_insertOps(racine, &ops, &values[0], sizeof(int));
+    assert(AVLtree_searchOps(racine, &ops, &values[3]));
+    assert(AVLtree_stats(&ops, &stats));
+    assert(10 == stats.nodesCreated && 0 == stats.nodesFreed);
+    assert(5 == stats.rotations && 1 == stats.doubleRotations);
+    assert(12 == stats.searches);
+    //un seul appel de 'cmp3' par noeud visite
+    assert(stats.compares == stats.pathLength);
+    for (total = 0, index = 0; index <= AVLTREE_MAX_HEIGHT; index++)
+        total += stats.depthHistogram[index];
+    assert(total == stats.searches);
+    assert(1 == stats.depthHistogram[0]);
+
+    AVLtree_statsReset(&ops);
+    for (index = 0; index < 10; index++)
+        racine = AVLtree_deleteOps(racine, &ops, &values[index]);
+    assert(!racine);
+    assert(AVLtree_stats(&ops, &stats));
+    assert(10 == stats.nodesFreed && 0 == stats.nodesCreated);
+
+    //avec des compteurs, une union demandee sur 4 threads reste sequentielle
+    for (index = 0; index < 30000; index++)
+        evens[index] = 2 * index;
+    for (index = 0; index < 20000; index++)
+        thirds[index] = 3 * index;
+    racine = AVLtree_buildFromSorted(evens, 30000, sizeof(int));
+    other = AVLtree_buildFromSorted(thirds, 20000, sizeof(int));
+    AVLtree_statsReset(&ops);
+    racine = AVLtree_union(racine, other, &ops, 4);
+    assert(AVLtree_stats(&ops, &stats));
+    assert(10000 == stats.nodesFreed && 40000 == AVLtree_getSize(racine));
+    //de meme pour les lots
+    for (index = 0; index < 20000; index++)
+        thirds[index] = 6 * index + 1;
+    AVLtree_statsReset(&ops);
+    racine = AVLtree_insertBatch(racine, &ops, thirds, 20000, sizeof(int), 4);
+    assert(AVLtree_stats(&ops, &stats));
+    assert(20000 == stats.nodesCreated && 60000 == AVLtree_getSize(racine));
+    racine = AVLtree_deleteBatch(racine, &ops, thirds, 20000, sizeof(int), 4);
+    assert(AVLtree_stats(&ops, &stats));
+    assert(20000 == stats.nodesFreed && 40000 == AVLtree_getSize(racine));
+    AVLtree_deleteTreeOps(&racine, &ops);
+    printf("PASS -> AVLtree_stats\n");
+#else
+    AVLOps      ops = { .cmp3 = compare3 };
+
+    for (index = 0; index < 10; index++)
+        racine = AVLtree_insertOps(racine, &ops, &values[index], sizeof(int));
+    assert(!AVLtree_stats(&ops, &stats));
+    assert(0 == stats.compares && 0 == stats.searches);
+    AVLtree_deleteTree(&racine);
+    printf("PASS -> AVLtree_stats (instrumentation non compilee)\n");
+#endif
+}
+
+DEFINE_AVLTREE(IntTree, int, AVLTYPED_CMP)
+
+/**
+ * Verifie l'ordre et les hauteurs d'un arbre type ; renvoie sa hauteur.
+ */
+int     checkIntTree(IntTreeNode *node, int *min, int *max) {
+    int hl, hr;
+
+    if (!node)
+        return 0;
+    if (min)
+        assert(*min < node->key);
+    if (max)
+        assert(node->key < *max);
+    hl = checkIntTree(node->left, min, &node->key);
+    hr = checkIntTree(node->right, &node->key, max);
+    assert(hl - hr <= 1 && hr - hl <= 1);
+    assert(node->height == 1 + (hl > hr ? hl : hr));
+    return node->height;
+}
+
+bool    collectInt(int *key, void *extra) {
+    int **cursor = (int **) extra;
+
+    *(*cursor)++ = *key;
+    return true;
+}
+
+/**
+ * Tests de l'arbre type genere par DEFINE_AVLTREE : memes resultats que l'API generique
+ * sur une suite d'insertions et de suppressions dans le desordre.
+ */
+void    testTypedAVL(void){
+    static int  keys[2000];
+    IntTreeNode *racine = NULL;
+    int         *cursor;
+    int         index, key;
+
+    for (index = 0; index < 2000; index++) {
+        key = (index * 7919) % 2000;
+        racine = IntTree_insert(racine, key);
+    }
+    racine = IntTree_insert(racine, 5);
+    checkIntTree(racine, NULL, NULL);
+    cursor = keys;
+    IntTree_in_order(racine, collectInt, &cursor);
+    assert(cursor == keys + 2000);
+    for (index = 0; index < 2000; index++)
+        assert(keys[index] == index);
+    assert(IntTree_search(racine, 1999) && !IntTree_search(racine, 2000));
+
+    for (index = 0; index < 2000; index += 3)
+        racine = IntTree_delete(racine, (index * 7919) % 2000);
+    racine = IntTree_delete(racine, -1);
+    checkIntTree(racine, NULL, NULL);
+    for (index = 0; index < 2000; index++)
+        assert(!IntTree_search(racine, (index * 7919) % 2000) == !(index % 3));
+    IntTree_deleteTree(&racine);
+    assert(!racine);
+    printf("PASS -> DEFINE_AVLTREE\n");
+}
+
+/**
+ * Verifie l'ordre et les hauteurs du sous-arbre compact d'indice 'index' ; renvoie sa
+ * hauteur et compte ses noeuds dans '*count'.
+ */
+int     checkCompact(const AVLCompact *tree, uint32_t index, int *min, int *max, size_t *count) {
+    AVLCompactNode  *node;
+    int             *data, hl, hr;
+
+    if (index == AVLCOMPACT_NIL)
+        return 0;
+    node = AVLcompact_getNode(tree, index);
+    data = (int*)AVLcompact_getData(tree, index);
+    if (min)
+        assert(*min < *data);
+    if (max)
+        assert(*data < *max);
+    hl = checkCompact(tree, node->left, min, data, count);
+    hr = checkCompact(tree, node->right, data, max, count);
+    assert(hl - hr <= 1 && hr - hl <= 1);
+    assert(node->height == 1 + (hl > hr ? hl : hr));
+    (*count)++;
+    return node->height;
+}
+
+int     compareChar(const void * a, const void * b) {
+    return (*(char*)a > *(char*)b) - (*(char*)a < *(char*)b);
+}
+
+bool    collectData(void * a, void * b) {
+    return collectInt((int*)a, b);
+}
+
+/**
+ * Tests de l'arbre compact : insertions et suppressions aleatoires comparees a un tableau
+ * de presence, reutilisation des cases liberees et taille des noeuds.
+ */
+void    testCompactAVL(void){
+    AVLCompact  tree;
+    bool        present[512] = { false };
+    int         index, value, nbPresent = 0;
+    size_t      count, memory;
+    int         sorted[512], *cursor;
+
+    assert(AVLcompact_init(&tree, sizeof(int), compare3));
+    //16 octets par entier, contre 32 pour 'struct AVLTreeNode' avant l'arrondi de malloc
+    assert(16 == AVLcompact_nodeSize(sizeof(int)));
+    for (index = 0; index < 4000; index++) {
+        value = rand() % 512;
+        if (rand() % 3) {
+            assert(AVLcompact_insert(&tree, &value) == !present[value]);
+            nbPresent += !present[value];
+            present[value] = true;
+        } else {
+            assert(AVLcompact_delete(&tree, &value) == present[value]);
+            nbPresent -= present[value];
+            present[value] = false;
+        }
+        count = 0;
+        checkCompact(&tree, tree.root, NULL, NULL, &count);
+        assert(count == AVLcompact_getSize(&tree));
+    }
+    assert(nbPresent == (int) AVLcompact_getSize(&tree));
+    for (value = 0; value < 512; value++)
+        assert(present[value] == (AVLcompact_search(&tree, &value) != NULL));
+
+    cursor = sorted;
+    AVLcompact_in_order(&tree, collectData, &cursor);
+    assert(cursor - sorted == nbPresent);
+    for (cursor = sorted, value = 0; value < 512; value++)
+        if (present[value])
+            assert(*cursor++ == value);
+    printf("PASS -> AVLcompact_insert / AVLcompact_delete\n");
+
+    //les cases liberees sont reprises avant d'agrandir le tableau
+    memory = AVLcompact_getMemory(&tree);
+    for (value = 0; value < 512; value++)
+        AVLcompact_delete(&tree, &value);
+    assert(0 == AVLcompact_getSize(&tree) && AVLCOMPACT_NIL == tree.root);
+    for (value = 0; value < nbPresent; value++)
+        assert(AVLcompact_insert(&tree, &value));
+    assert(memory == AVLcompact_getMemory(&tree));
+    assert(AVLcompact_getHeight(&tree) <= 10);
+    AVLcompact_destroy(&tree);
+    assert(0 == AVLcompact_getMemory(&tree));
+
+    //donnee d'un octet : placee apres l'entete et non dans son remplissage
+    assert(AVLcompact_init(&tree, sizeof(char), compareChar));
+    assert(tree.dataOffset >= sizeof(AVLCompactNode) && 16 == AVLcompact_nodeSize(sizeof(char)));
+    for (value = 0; value < 100; value++)
+        assert(AVLcompact_insert(&tree, &(char){ (char) value }));
+    for (value = 0; value < 100; value += 2)
+        assert(AVLcompact_delete(&tree, &(char){ (char) value }));
+    for (value = 0; value < 100; value++)
+        assert((value % 2 != 0) == (AVLcompact_search(&tree, &(char){ (char) value }) != NULL));
+    AVLcompact_destroy(&tree);
+    printf("PASS -> AVLcompact_reserve / reutilisation\n");
+}
+
+typedef struct Record {
+    int     id;
+    char    payload[1020];
+} Record;
+
+bool    buildRecord(void * value, void * extra) {
+    Record  *record = (Record*)value;
+    int     *id = (int*)extra;
+
+    if (*id < 0)
+        return false;
+    record->id = *id;
+    memset(record->payload, *id & 0xFF, sizeof(record->payload));
+    return true;
+}
+
+void    countDestroy(void * value, void * extra) {
+    (*(int*)extra)++;
+}
+
+bool    checkRecord(const void * key, void * value, void * extra) {
+    int *previous = (int*)extra;
+
+    assert(*(int*)key > *previous);
+    assert(((Record*)value)->id == *(int*)key);
+    *previous = *(int*)key;
+    return true;
+}
+
+/**
+ * Tests du dictionnaire cle/valeur, valeurs dans le noeud puis hors du noeud : construction
+ * sur place, remplacement, echec de construction, suppression avec destruction et parcours.
+ */
+void    testKeyValueAVL(void){
+    AVLKVStorage    storages[] = { AVLKV_INLINE, AVLKV_OUT_OF_LINE };
+    AVLKV           kv;
+    AVLPool         pool;
+    Record          *record, copy = { .id = 42 };
+    AVLTree         node;
+    bool            inserted;
+    int             s, key, nbDestroyed, previous;
+
+    for (s = 0; s < 2; s++) {
+        assert(AVLkv_init(&kv, sizeof(int), sizeof(Record), storages[s], compare3));
+        for (key = 0; key < 500; key++) {
+            record = (Record*)AVLkv_emplace(&kv, &key, buildRecord, &key, &inserted);
+            assert(record && inserted && record->id == key);
+            //alignement independant des champs du noeud (verifier aussi avec make ORDER_STATISTIC=n)
+            assert(0 == (uintptr_t) record % 8);
+        }
+        //cle deja presente : la valeur existante est renvoyee sans construction
+        key = 7;
+        record = (Record*)AVLkv_emplace(&kv, &key, buildRecord, &(int){ -1 }, &inserted);
+        assert(record && !inserted && 7 == record->id);
+        //construction refusee : rien n'est insere
+        key = 1000;
+        assert(!AVLkv_emplace(&kv, &key, buildRecord, &(int){ -1 }, &inserted) && !inserted);
+        assert(!AVLkv_get(&kv, &key));
+        assert(500 == AVLkv_getSize(&kv));
+        checkAVL(kv.root, NULL, NULL);
+
+        key = 42;
+        assert(AVLkv_put(&kv, &key, &copy));
+        assert(500 == AVLkv_getSize(&kv));
+        assert(42 == ((Record*)AVLkv_get(&kv, &key))->id);
+
+        //la suppression decroche le noeud : les autres valeurs ne bougent pas
+        node = kv.root;
+        key = *(int*)node->data;
+        assert(node->left && node->right);
+        record = (Record*)AVLkv_get(&kv, &(int){ key + 1 });
+        nbDestroyed = 0;
+        assert(AVLkv_delete(&kv, &key, countDestroy, &nbDestroyed));
+        assert(!AVLkv_delete(&kv, &key, countDestroy, &nbDestroyed));
+        assert(1 == nbDestroyed);
+        assert(record == AVLkv_get(&kv, &(int){ key + 1 }));
+        checkAVL(kv.root, NULL, NULL);
+
+        previous = -1;
+        AVLkv_in_order(&kv, checkRecord, &previous);
+        assert(499 == previous);
+        AVLkv_destroy(&kv, countDestroy, &nbDestroyed);
+        assert(500 == nbDestroyed && !kv.root);
+    }
+
+    //noeuds pris dans le pool de 'ops', y compris quand la construction echoue
+    assert(AVLkv_init(&kv, sizeof(int), sizeof(Record), AVLKV_INLINE, compare3));
+    assert(AVLpool_init(&pool, kv.valueOffset + kv.valueSize, 64));
+    kv.ops.pool = &pool;
+    for (key = 0; key < 100; key++)
+        assert(AVLkv_emplace(&kv, &key, buildRecord, &key, NULL));
+    assert(!AVLkv_emplace(&kv, &key, buildRecord, &(int){ -1 }, NULL));
+    assert(100 == AVLpool_getSize(&pool));
+    assert(0 == (uintptr_t) AVLkv_get(&kv, &(int){ 50 }) % 8);
+    assert(AVLkv_delete(&kv, &(int){ 50 }, NULL, NULL));
+    assert(99 == AVLpool_getSize(&pool));
+    AVLkv_destroy(&kv, NULL, NULL);
+    assert(0 == AVLpool_getSize(&pool));
+    AVLpool_release(&pool);
+    printf("PASS -> AVLkv_emplace / AVLkv_delete\n");
+}
+
+/**
+ * Tests de la poignee : apres chaque insertion, suppression ou retrait, le minimum, le
+ * maximum et le nombre d'elements tenus a jour doivent correspondre a l'arbre.
+ */
+void    testHandleAVL(void){
+    AVLHandle   handle;
+    bool        present[512] = { false };
+    int         index, value, popped, nbPresent = 0, previous;
+#if AVLTREE_STATS
+    AVLStats    counters, stats;
+#endif
+
+    nbCompare3 = 0;
+    assert(AVLhandle_init(&handle, sizeof(int), countCompare3, NULL));
+#if AVLTREE_STATS
+    handle.ops.stats = &counters;
+    AVLtree_statsReset(&handle.ops);
+#endif
+    assert(!AVLhandle_peekMin(&handle) && !AVLhandle_popMax(&handle, NULL));
+    for (index = 0; index < 5000; index++) {
+        value = rand() % 512;
+        switch (rand() % 4) {
+        case 0:
+            assert(AVLhandle_delete(&handle, &value) == present[value]);
+            nbPresent -= present[value];
+            present[value] = false;
+            break;
+        case 1:
+            if (AVLhandle_popMin(&handle, &popped)) {
+                for (value = 0; !present[value]; value++);
+                assert(popped == value);
+                present[value] = false;
+                nbPresent--;
+            }
+            break;
+        case 2:
+            if (AVLhandle_popMax(&handle, &popped)) {
+                for (value = 511; !present[value]; value--);
+                assert(popped == value);
+                present[value] = false;
+                nbPresent--;
+            }
+            break;
+        default:
+            assert(AVLhandle_insert(&handle, &value) == !present[value]);
+            nbPresent += !present[value];
+            present[value] = true;
+        }
+        checkAVL(handle.root, NULL, NULL);
+        assert((size_t) nbPresent == AVLhandle_getSize(&handle));
+        assert(AVLtree_getMIN(handle.root) == handle.min);
+        assert(AVLtree_getMAX(handle.root) == handle.max);
+    }
+    printf("PASS -> AVLhandle_insert / delete / popMin / popMax\n");
+
+    //file de priorite : les retraits ne font aucune comparaison
+    for (value = 0; value < 512; value++)
+        AVLhandle_insert(&handle, &value);
+    nbCompare3 = 0;
+    previous = -1;
+    while (AVLhandle_popMin(&handle, &popped)) {
+        assert(popped > previous);
+        assert(!handle.min || *(int*)AVLhandle_peekMin(&handle) > popped);
+        previous = popped;
+    }
+    assert(0 == nbCompare3 && 511 == previous && 0 == AVLhandle_getSize(&handle));
+#if AVLTREE_STATS
+    //arbre vide : chaque noeud cree a ete libere
+    assert(AVLtree_stats(&handle.ops, &stats) && stats.nodesCreated == stats.nodesFreed);
+#endif
+    AVLhandle_destroy(&handle);
+    printf("PASS -> AVLhandle_peekMin / peekMax\n");
+}
+
+/**
+ * Tests des recherches par lots : memes resultats que des recherches une a une, pour des
+ * lots plus petits, egaux ou plus grands que le nombre de descentes menees de front.
+ */
+void    testSearchBatchAVL(void){
+    static int      values[100];
+    static const void *keys[100];
+    AVLTree         results[100];
+    AVLTree         racine;
+    size_t          sizes[] = { 0, 1, 15, 16, 17, 100 };
+    size_t          s, i;
+
+    racine = multiplesTree(3, 3000);
+    for (i = 0; i < 100; i++) {
+        values[i] = rand() % 3100 - 50;
+        keys[i] = &values[i];
+    }
+    for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        AVLtree_searchBatch(racine, compare3, keys, sizes[s], results);
+        for (i = 0; i < sizes[s]; i++)
+            assert(results[i] == AVLtree_search3(racine, compare3, keys[i]));
+    }
+    AVLtree_deleteTree(&racine);
+    AVLtree_searchBatch(racine, compare3, keys, 100, results);
+    for (i = 0; i < 100; i++)
+        assert(!results[i]);
+    printf("PASS -> AVLtree_searchBatch\n");
+}
+
+bool    collectMapped(const void * a, void * b) {
+    return collectInt((int*)a, b);
+}
+
+/**
+ * Tests du format projete : recherches, bornes inferieures et parcours lus dans le
+ * fichier, compares a l'arbre d'origine, puis rejet d'un fichier tronque.
+ */
+void    testMappedAVL(void){
+    static int      collected[1000];
+    const char      *path = "test_mapped.avl";
+    AVLMapped       mapped;
+    AVLMappedCursor cursor;
+    AVLMappedHeader header;
+    AVLTree         racine;
+    FILE            *file;
+    const int       *found;
+    int             sizes[] = { 0, 1, 2, 7, 1000 };
+    int             s, key, *end;
+    bool            valid;
+
+    for (s = 0; s < (int) (sizeof(sizes) / sizeof(sizes[0])); s++) {
+        racine = multiplesTree(3, 3 * sizes[s]);
+        assert(AVLmapped_write(racine, sizeof(int), path));
+        assert(AVLmapped_open(&mapped, path));
+        assert(AVLtree_getSize(racine) == AVLmapped_getSize(&mapped));
+
+        for (key = -1; key <= 3 * sizes[s]; key++) {
+            found = (const int *) AVLmapped_search(&mapped, compare3, &key);
+            if (key >= 0 && key % 3 == 0 && key < 3 * sizes[s])
+                assert(found && *found == key);
+            else
+                assert(!found);
+
+            AVLmapped_cursorInit(&cursor, &mapped);
+            valid = AVLmapped_cursorLowerBound(&cursor, compare3, &key);
+            if (key <= 3 * (sizes[s] - 1)) {
+                assert(valid && *(const int *) AVLmapped_cursorGetData(&cursor) == (key < 0 ? 0 : (key + 2) / 3 * 3));
+                if (AVLmapped_cursorNext(&cursor))
+                    assert(*(const int *) AVLmapped_cursorGetData(&cursor) == (key < 0 ? 3 : (key + 2) / 3 * 3 + 3));
+            } else {
+                assert(!valid && !AVLmapped_cursorValid(&cursor));
+            }
+        }
+
+        end = collected;
+        AVLmapped_in_order(&mapped, collectMapped, &end);
+        assert(end - collected == sizes[s]);
+        for (key = 0; key < sizes[s]; key++)
+            assert(collected[key] == 3 * key);
+
+        AVLmapped_close(&mapped);
+        AVLtree_deleteTree(&racine);
+    }
+
+    //un fichier tronque est refuse a l'ouverture
+    racine = multiplesTree(1, 100);
+    assert(AVLmapped_write(racine, sizeof(int), path));
+    AVLtree_deleteTree(&racine);
+    assert((file = fopen(path, "rb")));
+    assert(fseek(file, 0, SEEK_END) == 0);
+    assert(truncate(path, ftell(file) - 1) == 0);
+    fclose(file);
+    assert(!AVLmapped_open(&mapped, path));
+
+    //des tailles forgees qui feraient deborder les calculs de taille sont refusees
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, AVLMAPPED_MAGIC, sizeof(header.magic));
+    header.version = 1;
+    header.byteOrder = AVLMAPPED_BYTE_ORDER;
+    header.elemSize = sizeof(int);
+    header.nodeSize = UINT64_C(1) << 63;
+    header.nbNodes = 2;
+    header.root = 2;
+    assert((file = fopen(path, "wb")));
+    assert(fwrite(&header, sizeof(header), 1, file) == 1);
+    fclose(file);
+    assert(!AVLmapped_open(&mapped, path));
+    header.elemSize = UINT64_MAX - 7;
+    header.nodeSize = 16;
+    assert((file = fopen(path, "wb")));
+    assert(fwrite(&header, sizeof(header), 1, file) == 1);
+    fclose(file);
+    assert(!AVLmapped_open(&mapped, path));
+
+    remove(path);
+    assert(!AVLmapped_open(&mapped, path));
+    printf("PASS -> AVLmapped_open\n");
+}
+
+typedef struct {
+    long long   sum;
+    size_t      count;
+} SumAcc;
+
+typedef struct {
+    int         *items;
+    size_t      count;
+    size_t      capacity;
+} ListAcc;
+
+void    sumMap(void * acc, const void * data, void * context) {
+    ((SumAcc*)acc)->sum += *(const int*)data;
+    ((SumAcc*)acc)->count++;
+    (void) context;
+}
+
+void    sumCombine(void * acc, void * other, void * context) {
+    ((SumAcc*)acc)->sum += ((SumAcc*)other)->sum;
+    ((SumAcc*)acc)->count += ((SumAcc*)other)->count;
+    (void) context;
+}
+
+void    listAppend(ListAcc *list, const int *items, size_t count) {
+    if (list->count + count > list->capacity) {
+        list->capacity = 2 * (list->count + count);
+        list->items = (int*) realloc(list->items, sizeof(int) * list->capacity);
+        assert(list->items);
+    }
+    memcpy(list->items + list->count, items, sizeof(int) * count);
+    list->count += count;
+}
+
+void    listMap(void * acc, const void * data, void * context) {
+    listAppend((ListAcc*)acc, (const int*)data, 1);
+    (void) context;
+}
+
+void    listCombine(void * acc, void * other, void * context) {
+    listAppend((ListAcc*)acc, ((ListAcc*)other)->items, ((ListAcc*)other)->count);
+    free(((ListAcc*)other)->items);
+    (void) context;
+}
+
+/**
+ * Tests des reductions paralleles : somme sans ordre et concatenation ordonnee, sur un
+ * arbre assez haut pour etre reparti entre les threads, puis sur un arbre vide.
+ */
+void    testParallelAVL(void){
+    static int      values[100000];
+    AVLReduceOps    sumOps = { .accSize = sizeof(SumAcc), .map = sumMap, .combine = sumCombine };
+    AVLReduceOps    listOps = { .accSize = sizeof(ListAcc), .map = listMap, .combine = listCombine };
+    SumAcc          sum;
+    ListAcc         list;
+    AVLTree         racine;
+    unsigned int    threads[] = { 1, 2, 4 };
+    size_t          t, i;
+
+    for (i = 0; i < 100000; i++)
+        values[i] = (int) i;
+    racine = AVLtree_buildFromSorted(values, 100000, sizeof(int));
+    assert(AVLtree_getHeight(racine) > AVLPARALLEL_GRAIN_HEIGHT + 2);
+
+    for (t = 0; t < sizeof(threads) / sizeof(threads[0]); t++) {
+        AVLtree_parallel_reduce(racine, &sumOps, &sum, threads[t]);
+        assert(sum.count == 100000 && sum.sum == 99999LL * 100000 / 2);
+
+        AVLtree_parallel_reduce_ordered(racine, &listOps, &list, threads[t]);
+        assert(list.count == 100000);
+        for (i = 0; i < list.count; i++)
+            assert(list.items[i] == (int) i);
+        free(list.items);
+    }
+    AVLtree_deleteTree(&racine);
+
+    sumOps.identity = &(SumAcc){ 7, 1 };
+    AVLtree_parallel_reduce(racine, &sumOps, &sum, 4);
+    assert(sum.sum == 7 && sum.count == 1);
+    AVLtree_parallel_reduce_ordered(racine, &listOps, &list, 4);
+    assert(list.count == 0 && !list.items);
+    printf("PASS -> AVLtree_parallel_reduce\n");
+}
+
+/**
+ * Tests de la destruction par etapes (chaque etape libere au plus le budget demande,
+ * suivi par le pool) et du thread de recuperation.
+ */
+void    testReclaimAVL(void){
+    AVLPool         pool;
+    AVLOps          ops = { .cmp3 = compare3, .pool = &pool };
+    AVLTeardown     teardown;
+    AVLReclaimer    *reclaimer;
+    AVLTree         racine = AVLtree_new();
+    size_t          remaining, steps;
+    int             value;
+
+    assert(AVLpool_init(&pool, sizeof(int), 64));
+    for (value = 0; value < 10000; value++)
+        racine = AVLtree_insertOps(racine, &ops, &(int){ (value * 7919) % 10000 }, sizeof(int));
+    AVLteardown_init(&teardown, &racine, &ops);
+    assert(!racine && !AVLteardown_isDone(&teardown));
+    for (steps = 0, remaining = 10000; AVLteardown_step(&teardown, 100); steps++) {
+        assert(remaining - AVLpool_getSize(&pool) <= 100);
+        remaining = AVLpool_getSize(&pool);
+    }
+    assert(AVLteardown_isDone(&teardown) && 0 == AVLpool_getSize(&pool));
+    assert(10000 == teardown.nbFreed && steps < 2 * 10000 / 100);
+    AVLpool_release(&pool);
+    printf("PASS -> AVLteardown_step\n");
+
+    assert((reclaimer = AVLreclaimer_create()));
+    racine = multiplesTree(1, 1000);
+    AVLreclaimer_submit(reclaimer, &racine);
+    assert(!racine);
+    AVLreclaimer_submit(reclaimer, &racine);
+    racine = multiplesTree(2, 10000);
+    AVLreclaimer_submit(reclaimer, &racine);
+    racine = multiplesTree(3, 3);
+    AVLreclaimer_submit(reclaimer, &racine);
+    AVLreclaimer_wait(reclaimer);
+    assert(6001 == AVLreclaimer_getFreed(reclaimer));
+    racine = multiplesTree(1, 100);
+    AVLreclaimer_submit(reclaimer, &racine);
+    AVLreclaimer_destroy(reclaimer);
+
+    racine = multiplesTree(1, 100);
+    AVLreclaimer_submit(NULL, &racine);
+    assert(!racine);
+    printf("PASS -> AVLreclaimer_submit\n");
+}
+
+bool    collectCounts(const void * a, size_t count, void * b) {
+    int **cursor = (int **) b;
+
+    *(*cursor)++ = *(const int*)a;
+    *(*cursor)++ = (int) count;
+    return true;
+}
+
+bool    collectConst(const void * a, void * b) {
+    return collectInt((int*)a, b);
+}
+
+/**
+ * Tests du multi-ensemble : compteurs compares a un tableau d'occurrences au fil
+ * d'insertions et de suppressions repetees, puis parcours avec et sans expansion.
+ */
+void    testMultisetAVL(void){
+    static int      occurrences[100];
+    static int      collected[5000];
+    AVLMultiset     set;
+    AVLPool         pool;
+    size_t          total, distinct;
+    int             step, value, *end;
+
+    assert(AVLmultiset_init(&set, sizeof(int), compare3));
+    for (step = 0; step < 5000; step++) {
+        value = rand() % 100;
+        if (rand() % 3) {
+            assert(AVLmultiset_insert(&set, &value) == (size_t) ++occurrences[value]);
+        } else if (occurrences[value]) {
+            assert(AVLmultiset_delete(&set, &value) == (size_t) --occurrences[value]);
+        } else {
+            assert(AVLmultiset_delete(&set, &value) == (size_t) -1);
+        }
+    }
+    total = 0;
+    distinct = 0;
+    for (value = 0; value < 100; value++) {
+        assert(AVLmultiset_count(&set, &value) == (size_t) occurrences[value]);
+        total += occurrences[value];
+        distinct += occurrences[value] != 0;
+    }
+    assert(AVLmultiset_getSize(&set) == total && AVLmultiset_getDistinct(&set) == distinct);
+    assert(AVLtree_getSize(set.root) == distinct);
+    printf("PASS -> AVLmultiset_insert\n");
+
+    value = 7;
+    assert(AVLmultiset_deleteAll(&set, &value) == (size_t) occurrences[7]);
+    assert(AVLmultiset_count(&set, &value) == 0);
+    total -= occurrences[7];
+    distinct -= occurrences[7] != 0;
+    occurrences[7] = 0;
+    assert(AVLmultiset_insertMany(&set, &(int){ 200 }, 3) == 3);
+    total += 3;
+    distinct++;
+    assert(AVLmultiset_getSize(&set) == total && AVLmultiset_getDistinct(&set) == distinct);
+
+    end = collected;
+    AVLmultiset_in_order(&set, collectCounts, &end);
+    assert((size_t) (end - collected) == 2 * distinct);
+    assert(end[-2] == 200 && end[-1] == 3);
+    end = collected;
+    AVLmultiset_in_order_expand(&set, collectConst, &end);
+    assert((size_t) (end - collected) == total);
+    end = collected;
+    for (value = 0; value < 100; value++)
+        for (step = 0; step < occurrences[value]; step++)
+            assert(*end++ == value);
+    assert(end[0] == 200 && end[1] == 200 && end[2] == 200);
+    AVLmultiset_destroy(&set);
+    assert(AVLmultiset_getSize(&set) == 0 && !set.root);
+
+    //un noeud par element distinct, pris dans le pool de 'ops'
+    assert(AVLpool_init(&pool, set.countOffset + sizeof(size_t), 16));
+    set.ops.pool = &pool;
+    for (step = 0; step < 300; step++)
+        assert(AVLmultiset_insert(&set, &(int){ step % 30 }));
+    assert(30 == AVLpool_getSize(&pool) && AVLmultiset_getSize(&set) == 300);
+    AVLmultiset_destroy(&set);
+    assert(0 == AVLpool_getSize(&pool));
+    AVLpool_release(&pool);
+    printf("PASS -> AVLmultiset_in_order\n");
+}
+
+/*
+ * Verifie que le doigt d'une poignee est un chemin de la racine jusqu'a 'value'.
+ */
+void    checkFinger(const AVLHandle *handle, int value) {
+    int level;
+
+    assert(handle->fingerDepth > 0 && handle->finger[0] == handle->root);
+    for (level = 1; level < handle->fingerDepth; level++)
+        assert(handle->finger[level] == handle->finger[level - 1]->left
+               || handle->finger[level] == handle->finger[level - 1]->right);
+    assert(value == *(int*)handle->finger[handle->fingerDepth - 1]->data);
+}
+
+/**
+ * Tests des insertions a partir d'un doigt : donnees croissantes (quelques comparaisons
+ * par insertion), puis aleatoires melangees a des suppressions, et depuis un curseur.
+ */
+void    testHintAVL(void){
+    AVLHandle   handle;
+    AVLCursor   cursor;
+    bool        present[512] = { false };
+    int         index, value, nbPresent = 0;
+
+    assert(AVLhandle_init(&handle, sizeof(int), countCompare3, NULL));
+    nbCompare3 = 0;
+    for (value = 0; value < 10000; value++) {
+        assert(AVLhandle_insertHint(&handle, NULL, &value));
+        checkFinger(&handle, value);
+    }
+    assert(nbCompare3 < 3 * 10000);
+    assert(!AVLhandle_insertHint(&handle, NULL, &(int){ 9999 }));
+    assert(!AVLhandle_insertHint(&handle, NULL, &(int){ 5000 }));
+    checkAVL(handle.root, NULL, NULL);
+    assert(10000 == AVLhandle_getSize(&handle) && 9999 == *(int*)AVLhandle_peekMax(&handle));
+    AVLhandle_destroy(&handle);
+
+    for (index = 0; index < 5000; index++) {
+        value = rand() % 512;
+        if (rand() % 4) {
+            assert(AVLhandle_insertHint(&handle, NULL, &value) == !present[value]);
+            if (!present[value])
+                checkFinger(&handle, value);
+            nbPresent += !present[value];
+            present[value] = true;
+        } else {
+            assert(AVLhandle_delete(&handle, &value) == present[value]);
+            nbPresent -= present[value];
+            present[value] = false;
+        }
+        checkAVL(handle.root, NULL, NULL);
+        assert((size_t) nbPresent == AVLhandle_getSize(&handle));
+        assert(AVLtree_getMIN(handle.root) == handle.min);
+        assert(AVLtree_getMAX(handle.root) == handle.max);
+    }
+    AVLhandle_destroy(&handle);
+    printf("PASS -> AVLhandle_insertHint\n");
+
+    for (value = 0; value < 1000; value += 2)
+        AVLhandle_insert(&handle, &value);
+    for (value = 1; value < 1000; value += 2) {
+        AVLcursor_init(&cursor, handle.root);
+        if (!AVLcursor_lowerBound(&cursor, compare3, &value))
+            assert(AVLcursor_last(&cursor));
+        assert(AVLhandle_insertHint(&handle, &cursor, &value));
+        checkFinger(&handle, value);
+    }
+    checkAVL(handle.root, NULL, NULL);
+    assert(1000 == AVLhandle_getSize(&handle));
+    AVLcursor_init(&cursor, handle.root);
+    AVLcursor_last(&cursor);
+    assert(!AVLhandle_insertHint(&handle, &cursor, &(int){ 999 }));
+    AVLhandle_destroy(&handle);
+    printf("PASS -> AVLhandle_insertHint (curseur)\n");
+}
+
+size_t  hashInt(const void * a) {
+    return (size_t) *(const int*)a;
+}
+
+bool    collectFirst(void * a, void * b) {
+    int **cursor = (int **) b;
+
+    *(*cursor)++ = *(int*)a;
+    return (*cursor)[-1] < 1009;
+}
+
+typedef struct ShardedArgs {
+    AVLSharded      *set;
+    int             first;
+    int             step;
+} ShardedArgs;
+
+/*
+ * Ecrivain : insere les cles first, first + step, ... puis retire une cle sur deux.
+ */
+void    *shardedWriter(void *arg) {
+    ShardedArgs *args = (ShardedArgs*)arg;
+    int         key;
+
+    for (key = args->first; key < 40000; key += args->step)
+        assert(AVLsharded_insert(args->set, &key));
+    for (key = args->first; key < 40000; key += 2 * args->step)
+        assert(AVLsharded_delete(args->set, &key));
+    return NULL;
+}
+
+/**
+ * Tests de l'ensemble reparti : ajouts croissants qui font reequilibrer le decoupage par
+ * intervalles, operations aleatoires comparees a un tableau de presence en mode hachage,
+ * parcours fusionnes dans l'ordre, puis ecrivains concurrents.
+ */
+void    testShardedAVL(void){
+    AVLSharded      set;
+    ShardedArgs     args[4];
+    pthread_t       threads[4];
+    bool            present[2000] = { false };
+    int             keys[50000], *cursor, bounds[2] = { 100, 200 };
+    int             index, value, nbPresent = 0;
+    unsigned int    shard;
+
+    assert(!AVLsharded_init(&set, 2, sizeof(int), compare3, bounds, 2));
+    assert(!AVLsharded_init(&set, 4, sizeof(int), compare3, (int[]){ 200, 100 }, 2));
+    assert(AVLsharded_init(&set, 8, sizeof(int), compare3, NULL, 0));
+    for (value = 0; value < 50000; value++)
+        assert(AVLsharded_insert(&set, &value));
+    assert(!AVLsharded_insert(&set, &(int){ 123 }));
+    assert(50000 == AVLsharded_getSize(&set) && AVLsharded_getRebalances(&set) > 0);
+    //les decoupages remplaces ont ete liberes
+    assert(!atomic_load(&set.layout)->previous);
+    for (shard = 0; shard < 8; shard++) {
+        checkAVL(set.shards[shard].root, NULL, NULL);
+        assert(AVLtree_getSize(set.shards[shard].root) == AVLsharded_getShardSize(&set, shard));
+        assert(AVLsharded_getShardSize(&set, shard) < 50000 / 2);
+    }
+    cursor = keys;
+    AVLsharded_in_order(&set, collectData, &cursor);
+    assert(cursor == keys + 50000);
+    for (index = 0; index < 50000; index++)
+        assert(keys[index] == index);
+    for (value = 1; value < 50000; value += 2)
+        assert(AVLsharded_delete(&set, &value));
+    assert(!AVLsharded_delete(&set, &(int){ 1 }));
+    assert(AVLsharded_search(&set, &(int){ 30000 }, &value) && value == 30000);
+    assert(!AVLsharded_search(&set, &(int){ 30001 }, NULL));
+    cursor = keys;
+    assert(500 == AVLsharded_range(&set, &(int){ 20000 }, &(int){ 21000 }, collectData, &cursor));
+    for (index = 0; index < 500; index++)
+        assert(keys[index] == 20000 + 2 * index);
+    AVLsharded_destroy(&set);
+    printf("PASS -> AVLsharded (intervalles, reequilibrage)\n");
+
+    assert(!AVLsharded_initHash(&set, 8, sizeof(int), compare3, NULL));
+    assert(AVLsharded_initHash(&set, 8, sizeof(int), compare3, hashInt));
+    for (index = 0; index < 20000; index++) {
+        value = rand() % 2000;
+        if (rand() % 3) {
+            assert(AVLsharded_insert(&set, &value) == !present[value]);
+            nbPresent += !present[value];
+            present[value] = true;
+        } else {
+            assert(AVLsharded_delete(&set, &value) == present[value]);
+            nbPresent -= present[value];
+            present[value] = false;
+        }
+    }
+    assert((size_t) nbPresent == AVLsharded_getSize(&set) && 0 == AVLsharded_getRebalances(&set));
+    cursor = keys;
+    AVLsharded_in_order(&set, collectData, &cursor);
+    assert(cursor == keys + nbPresent);
+    for (value = 0, index = 0; value < 2000; value++)
+        if (present[value])
+            assert(keys[index++] == value);
+    cursor = keys;
+    AVLsharded_range(&set, &(int){ 1000 }, NULL, collectFirst, &cursor);
+    assert(cursor > keys && cursor[-1] >= 1009);
+    for (index = 1; keys + index < cursor; index++)
+        assert(keys[index - 1] >= 1000 && keys[index - 1] < keys[index]);
+    AVLsharded_destroy(&set);
+    printf("PASS -> AVLsharded (hachage, fusion ordonnee)\n");
+
+    assert(AVLsharded_init(&set, 4, sizeof(int), compare3, NULL, 0));
+    for (index = 0; index < 4; index++) {
+        args[index] = (ShardedArgs) { &set, index, 4 };
+        pthread_create(&threads[index], NULL, shardedWriter, &args[index]);
+    }
+    for (index = 0; index < 4; index++)
+        pthread_join(threads[index], NULL);
+    assert(20000 == AVLsharded_getSize(&set) && !atomic_load(&set.layout)->previous);
+    cursor = keys;
+    AVLsharded_in_order(&set, collectData, &cursor);
+    assert(cursor == keys + 20000);
+    for (index = 0; index < 20000; index++)
+        assert(keys[index] == (index / 4) * 8 + 4 + index % 4);
+    AVLsharded_destroy(&set);
+    printf("PASS -> AVLsharded (ecrivains concurrents)\n");
+}
+
+/*
+ * Verifie hauteurs, ordre et augmentation 'maxHigh' d'un arbre d'intervalles ; renvoie sa
+ * hauteur.
+ */
+int     checkInterval(AVLTree node, const AVLInterval *min, int64_t *maxHigh) {
+    AVLInterval interval;
+    int64_t     maxLeft, maxRight;
+    int         hl, hr;
+
+    if (!node) {
+        *maxHigh = INT64_MIN;
+        return 0;
+    }
+    interval = AVLinterval_get(node);
+    assert(interval.low <= interval.high);
+    hl = checkInterval(node->left, min, &maxLeft);
+    hr = checkInterval(node->right, &interval, &maxRight);
+    assert(hl - hr <= 1 && hr - hl <= 1);
+    assert(node->height == 1 + (hl > hr ? hl : hr));
+    *maxHigh = interval.high;
+    *maxHigh = (maxLeft > *maxHigh) ? maxLeft : *maxHigh;
+    *maxHigh = (maxRight > *maxHigh) ? maxRight : *maxHigh;
+    assert(interval.maxHigh == *maxHigh);
+    return node->height;
+}
+
+bool    collectInterval(const AVLInterval * interval, void * b) {
+    AVLInterval **cursor = (AVLInterval **) b;
+
+    *(*cursor)++ = *interval;
+    return true;
+}
+
+typedef struct SumData {
+    int         key;
+    long long   sum;
+} SumData;
+
+//augmentation 'somme des cles du sous-arbre', sur le meme mecanisme
+void    sumAugment(AVLTree node) {
+    SumData data, child;
+
+    memcpy(&data, node->data, sizeof(data));
+    data.sum = data.key;
+    if (node->left) {
+        memcpy(&child, node->left->data, sizeof(child));
+        data.sum += child.sum;
+    }
+    if (node->right) {
+        memcpy(&child, node->right->data, sizeof(child));
+        data.sum += child.sum;
+    }
+    memcpy(node->data, &data, sizeof(data));
+}
+
+//verifie la somme de chaque noeud ; renvoie celle du sous-arbre
+long long checkSum(AVLTree node) {
+    SumData     data;
+    long long   sum;
+
+    if (!node)
+        return 0;
+    memcpy(&data, node->data, sizeof(data));
+    sum = data.key + checkSum(node->left) + checkSum(node->right);
+    assert(data.sum == sum);
+    return sum;
+}
+
+/**
+ * Tests de l'arbre d'intervalles : augmentation verifiee apres chaque modification,
+ * requetes de chevauchement et de piquage comparees a un parcours de tous les intervalles,
+ * puis une autre augmentation (somme) sur le moteur, par les lots, les operations
+ * ensemblistes et les coupes.
+ */
+void    testIntervalAVL(void){
+    AVLIntervalTree tree;
+    AVLInterval     all[1500], found[1500], *cursor;
+    AVLOps          ops = { .cmp3 = compare3, .augment = sumAugment };
+    AVLTree         racine = NULL, other = NULL, below, above, middle;
+    SumData         data, batch[1000];
+    int64_t         maxHigh, low, high;
+    long long       total = 0;
+    int             index, nbAll = 0, query, nbExpected, position;
+#if AVLTREE_STATS
+    AVLStats        counters, stats;
+#endif
+
+    AVLinterval_init(&tree, NULL);
+#if AVLTREE_STATS
+    tree.ops.stats = &counters;
+    AVLtree_statsReset(&tree.ops);
+#endif
+    assert(!AVLinterval_insert(&tree, 10, 5, NULL));
+    for (index = 0; index < 3000; index++) {
+        if (nbAll < 1500 && (nbAll == 0 || rand() % 3)) {
+            low = rand() % 10000;
+            high = low + rand() % ((rand() % 10) ? 50 : 2000);
+            all[nbAll] = (AVLInterval) { low, high, high, (void *) (intptr_t) (rand() % 2) };
+            if (AVLinterval_insert(&tree, low, high, all[nbAll].value))
+                nbAll++;
+            else
+                assert(!AVLinterval_insert(&tree, low, high, all[nbAll].value));
+        } else {
+            position = rand() % nbAll;
+            assert(AVLinterval_delete(&tree, all[position].low, all[position].high, all[position].value));
+            assert(!AVLinterval_delete(&tree, all[position].low, all[position].high, all[position].value));
+            all[position] = all[--nbAll];
+        }
+        checkInterval(tree.root, NULL, &maxHigh);
+        assert((size_t) nbAll == AVLinterval_getSize(&tree));
+    }
+    printf("PASS -> AVLinterval_insert / delete (augmentation)\n");
+
+    for (query = 0; query < 500; query++) {
+        low = rand() % 11000 - 500;
+        high = (query % 2) ? low : low + rand() % 300;
+        cursor = found;
+        if (query % 2)
+            assert(AVLinterval_stab(&tree, low, collectInterval, &cursor) == (size_t) (cursor - found));
+        else
+            assert(AVLinterval_overlap(&tree, low, high, collectInterval, &cursor) == (size_t) (cursor - found));
+        nbExpected = 0;
+        for (index = 0; index < nbAll; index++)
+            nbExpected += all[index].low <= high && all[index].high >= low;
+        assert(cursor - found == nbExpected);
+        for (index = 0; found + index < cursor; index++) {
+            assert(found[index].low <= high && found[index].high >= low);
+            assert(index == 0 || found[index - 1].low <= found[index].low);
+        }
+    }
+    assert(0 == AVLinterval_overlap(&tree, 10, 5, collectInterval, &cursor));
+    AVLinterval_destroy(&tree);
+    assert(0 == AVLinterval_stab(&tree, 100, collectInterval, &cursor));
+#if AVLTREE_STATS
+    assert(AVLtree_stats(&tree.ops, &stats) && stats.nodesCreated == stats.nodesFreed);
+#endif
+    printf("PASS -> AVLinterval_overlap / stab\n");
+
+    for (index = 0; index < 2000; index++) {
+        data = (SumData) { rand() % 1000, 0 };
+        if (rand() % 3 && !AVLtree_searchOps(racine, &ops, &data)) {
+            racine = AVLtree_insertOps(racine, &ops, &data, sizeof(data));
+            total += data.key;
+        } else if (AVLtree_searchOps(racine, &ops, &data)) {
+            racine = AVLtree_deleteOps(racine, &ops, &data);
+            total -= data.key;
+        }
+        memcpy(&data, racine ? racine->data : (void *) &(SumData) { 0, 0 }, sizeof(data));
+        assert(data.sum == total);
+    }
+    AVLtree_deleteTreeOps(&racine, &ops);
+    printf("PASS -> AVLOps.augment (somme)\n");
+
+    for (index = 0; index < 100; index++)
+        racine = AVLtree_insertOps(racine, &ops, &(SumData) { index * 7, 0 }, sizeof(SumData));
+    for (index = 0; index < 1000; index++)
+        batch[index] = (SumData) { rand() % 5000, 0 };
+    racine = AVLtree_insertBatch(racine, &ops, batch, 1000, sizeof(SumData), 1);
+    checkSum(racine);
+    for (index = 0; index < 500; index++)
+        batch[index] = (SumData) { rand() % 5000, 0 };
+    racine = AVLtree_deleteBatch(racine, &ops, batch, 500, sizeof(SumData), 1);
+    checkSum(racine);
+    for (index = 0; index < 300; index++)
+        other = AVLtree_insertOps(other, &ops, &(SumData) { rand() % 8000, 0 }, sizeof(SumData));
+    racine = AVLtree_union(racine, other, &ops, 1);
+    checkSum(racine);
+    middle = AVLtree_splitRange(racine, &ops, &(SumData) { 1000, 0 }, &(SumData) { 3000, 0 }, &below, &above);
+    checkSum(below);
+    checkSum(middle);
+    checkSum(above);
+    racine = AVLtree_join2Ops(AVLtree_join2Ops(below, middle, &ops), above, &ops);
+    checkSum(racine);
+    AVLtree_deleteTreeOps(&racine, &ops);
+    printf("PASS -> AVLOps.augment (lots, union, coupes)\n");
+}
+
 int main(){
     testArbresAVL();
+    testPoolAVL();
+    testCompare3AVL();
+    testIterativeAVL();
+    testOrderStatisticAVL();
+    testCursorAVL();
+    testBuildAVL();
+    testSetOpsAVL();
+    testBatchAVL();
+    testConcurrentAVL();
+    testPersistentAVL();
+    testFrozenAVL();
+    testStatsAVL();
+    testTypedAVL();
+    testCompactAVL();
+    testKeyValueAVL();
+    testHandleAVL();
+    testSearchBatchAVL();
+    testMappedAVL();
+    testParallelAVL();
+    testReclaimAVL();
+    testMultisetAVL();
+    testHintAVL();
+    testShardedAVL();
+    testIntervalAVL();
 
     printf("\n\n-----RANDOM TREE-------\n");
 